@@ -1,13 +1,797 @@
+// Build: g++ -std=c++20 -O2 -march=native -pthread main.cpp -o main
+//        (add -DENABLE_METRICS=0 to compile the instrumentation out)
+
 #include <iostream>
 #include <limits>
 #include <string>
 #include <vector>
 #include <iomanip>
+#include <algorithm>
+#include <bit>
 #include <cctype>
+#include <cmath>
 #include <sstream>
+#include <fstream>
+#include <charconv>
+#include <string_view>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <latch>
+#include <chrono>
+#include <random>
+#include <coroutine>
+#include <optional>
+#include <utility>
+#include <type_traits>
+#include <stdexcept>
+#include <cerrno>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <climits>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <csignal>
+#include <netdb.h>
+#include <netinet/tcp.h>
+#include <spawn.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 using namespace std;
 
+// ================================================== METRICS CLASSES ==================================================
+#ifndef ENABLE_METRICS
+#define ENABLE_METRICS 1
+#endif
+
+// @brief Events counted by Metrics.
+enum class Counter : uint8_t {
+  MenuDispatches, ScriptCommands, ValidatorRetries, StudentsEvaluated, Conversions, TriangleRenders, RateDisplays,
+  ConversionCacheHits, ConversionCacheMisses,
+  COUNT
+};
+
+// @brief Operations whose latency Metrics records.
+enum class Timer : uint8_t {
+  GradeEvaluation, Conversion, DisplayRates, DisplayConversion, TriangleRender, ScriptCommand,
+  COUNT
+};
+
+/**
+ * @class Metrics
+ * @brief Per-thread counters and HDR-style latency histograms
+ *
+ * Every thread writes only to its own shard, with relaxed single-writer
+ * stores, so recording never contends. When a thread exits its totals
+ * are folded into a retired accumulator and its shard, zeroed, goes on a
+ * free list for the next thread, so the registry only grows to the peak
+ * number of live threads. Snapshots merge the retired totals with every
+ * shard and can be exported as Prometheus text or JSON.
+ *
+ * Histogram buckets are log-linear: 16 per power of two of nanoseconds,
+ * which bounds the error of any recorded value to about 6%.
+ *
+ * With ENABLE_METRICS=0 every recording call is an empty inline function
+ * and ScopedTimer is an empty object, so the instrumentation costs nothing.
+ */
+class Metrics {
+  public:
+    static constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::COUNT);
+    static constexpr size_t TIMER_COUNT = static_cast<size_t>(Timer::COUNT);
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = (40 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;   // Up to 2^40 ns (about 18 minutes)
+
+    static constexpr const char* COUNTER_NAMES[COUNTER_COUNT] = {
+      "menu_dispatches", "script_commands", "validator_retries", "students_evaluated", "conversions", "triangle_renders", "rate_displays",
+      "conversion_cache_hits", "conversion_cache_misses"
+    };
+    static constexpr const char* TIMER_NAMES[TIMER_COUNT] = {
+      "grade_evaluation", "conversion", "display_rates", "display_conversion", "triangle_render", "script_command"
+    };
+
+    // @brief Returns the bucket holding a latency of nanos.
+    static constexpr size_t bucketOf(uint64_t nanos) {
+      if (nanos < SUB_BUCKETS) return static_cast<size_t>(nanos);
+      int shift = bit_width(nanos) - 1 - SUB_BUCKET_BITS;
+      return min(BUCKET_COUNT - 1, static_cast<size_t>(shift + 1) * SUB_BUCKETS + static_cast<size_t>((nanos >> shift) & (SUB_BUCKETS - 1)));
+    }
+
+    // @brief Returns the smallest latency that falls into bucket.
+    static constexpr uint64_t bucketStart(size_t bucket) {
+      if (bucket < SUB_BUCKETS) return bucket;
+      size_t shift = bucket / SUB_BUCKETS - 1;
+      return (SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    }
+
+    /**
+     * @struct Snapshot
+     * @brief Totals merged across every thread
+     */
+    struct Snapshot {
+      uint64_t counters[COUNTER_COUNT] = {};
+      struct Histogram {
+        uint64_t count = 0;
+        uint64_t sumNanos = 0;
+        uint64_t maxNanos = 0;
+        vector<uint64_t> buckets = vector<uint64_t>(BUCKET_COUNT);
+
+        // @brief Adds one sample to a histogram owned by the calling thread (not a Metrics shard).
+        void record(uint64_t nanos) {
+          buckets[bucketOf(nanos)]++;
+          count++;
+          sumNanos += nanos;
+          maxNanos = max(maxNanos, nanos);
+        }
+
+        void merge(const Histogram& other) {
+          count += other.count;
+          sumNanos += other.sumNanos;
+          maxNanos = max(maxNanos, other.maxNanos);
+          for (size_t b = 0; b < BUCKET_COUNT; b++) buckets[b] += other.buckets[b];
+        }
+
+        // @brief Returns the start of the bucket holding the p-th percentile (0 if empty).
+        uint64_t percentile(double p) const {
+          if (count == 0) return 0;
+          uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(count - 1)) + 1, seen = 0;
+          for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            seen += buckets[bucket];
+            if (seen >= rank) return bucketStart(bucket);
+          }
+          return maxNanos;
+        }
+      } timers[TIMER_COUNT];
+    };
+
+#if ENABLE_METRICS
+    // @brief Adds amount to a counter of the calling thread.
+    static void count(Counter counter, uint64_t amount = 1) {
+      bump(shard().counters[static_cast<size_t>(counter)], amount);
+    }
+
+    // @brief Records one latency sample of the calling thread.
+    static void record(Timer timer, uint64_t nanos) {
+      Shard::Histogram& histogram = shard().timers[static_cast<size_t>(timer)];
+      bump(histogram.buckets[bucketOf(nanos)], 1);
+      bump(histogram.count, 1);
+      bump(histogram.sumNanos, nanos);
+      if (nanos > histogram.maxNanos.load(memory_order_relaxed)) histogram.maxNanos.store(nanos, memory_order_relaxed);
+    }
+
+    /**
+     * @class ScopedTimer
+     * @brief Records the lifetime of a scope into a Timer
+     */
+    class ScopedTimer {
+      public:
+        explicit ScopedTimer(Timer timer) : timer(timer), started(chrono::steady_clock::now()) {}
+        ~ScopedTimer() {
+          auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - started);
+          record(timer, static_cast<uint64_t>(elapsed.count()));
+        }
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+      private:
+        Timer timer;
+        chrono::steady_clock::time_point started;
+    };
+
+    // @brief Merges the totals of exited threads with every live thread's shard.
+    static Snapshot snapshot() {
+      lock_guard<mutex> guard(registryLock());
+      Snapshot merged = retired();
+      for (const unique_ptr<Shard>& shard : registry()) mergeShard(merged, *shard);
+      return merged;
+    }
+#else
+    static void count(Counter, uint64_t = 1) {}
+    static void record(Timer, uint64_t) {}
+
+    class ScopedTimer {
+      public:
+        explicit ScopedTimer(Timer) {}
+    };
+
+    static Snapshot snapshot() { return Snapshot(); }
+#endif
+
+    // @brief Returns true if the instrumentation is compiled in.
+    static constexpr bool enabled() { return ENABLE_METRICS != 0; }
+
+    /**
+     * @brief Writes a snapshot in the Prometheus text exposition format
+     *
+     * Counters become app_<name>_total. Each timer becomes an
+     * app_<name>_seconds histogram with one cumulative bucket per power
+     * of two up to its largest sample.
+     */
+    static void writePrometheus(ostream& out, const Snapshot& metrics) {
+      for (size_t c = 0; c < COUNTER_COUNT; c++) {
+        out << "# TYPE app_" << COUNTER_NAMES[c] << "_total counter\n"
+            << "app_" << COUNTER_NAMES[c] << "_total " << metrics.counters[c] << "\n";
+      }
+      for (size_t t = 0; t < TIMER_COUNT; t++) {
+        const Snapshot::Histogram& histogram = metrics.timers[t];
+        const string name = string("app_") + TIMER_NAMES[t] + "_seconds";
+        out << "# TYPE " << name << " histogram\n";
+
+        uint64_t cumulative = 0;
+        size_t bucket = 0;
+        for (int exponent = SUB_BUCKET_BITS; exponent <= 40; exponent++) {
+          uint64_t bound = uint64_t(1) << exponent;
+          for (; bucket < BUCKET_COUNT && bucketStart(bucket) < bound; bucket++) cumulative += histogram.buckets[bucket];
+          out << name << "_bucket{le=\"" << static_cast<double>(bound) * 1e-9 << "\"} " << cumulative << "\n";
+          if (cumulative == histogram.count) break;
+        }
+        out << name << "_bucket{le=\"+Inf\"} " << histogram.count << "\n"
+            << name << "_sum " << static_cast<double>(histogram.sumNanos) * 1e-9 << "\n"
+            << name << "_count " << histogram.count << "\n";
+      }
+    }
+
+    // @brief Writes a snapshot as JSON, with percentiles per timer.
+    static void writeJson(ostream& out, const Snapshot& metrics) {
+      out << "{\"enabled\": " << (enabled() ? "true" : "false") << ", \"counters\": {";
+      for (size_t c = 0; c < COUNTER_COUNT; c++) {
+        out << (c == 0 ? "" : ", ") << "\"" << COUNTER_NAMES[c] << "\": " << metrics.counters[c];
+      }
+      out << "}, \"latency_ns\": {";
+      for (size_t t = 0; t < TIMER_COUNT; t++) {
+        const Snapshot::Histogram& histogram = metrics.timers[t];
+        out << (t == 0 ? "" : ", ") << "\"" << TIMER_NAMES[t] << "\": {\"count\": " << histogram.count
+            << ", \"sum\": " << histogram.sumNanos
+            << ", \"p50\": " << histogram.percentile(50)
+            << ", \"p90\": " << histogram.percentile(90)
+            << ", \"p99\": " << histogram.percentile(99)
+            << ", \"p999\": " << histogram.percentile(99.9)
+            << ", \"max\": " << histogram.maxNanos << "}";
+      }
+      out << "}}\n";
+    }
+
+  private:
+#if ENABLE_METRICS
+    // One thread's counters; written only by that thread
+    struct Shard {
+      atomic<uint64_t> counters[COUNTER_COUNT] = {};
+      struct Histogram {
+        atomic<uint64_t> count{0};
+        atomic<uint64_t> sumNanos{0};
+        atomic<uint64_t> maxNanos{0};
+        atomic<uint64_t> buckets[BUCKET_COUNT] = {};
+      } timers[TIMER_COUNT];
+    };
+
+    static mutex& registryLock() {
+      static mutex lock;
+      return lock;
+    }
+
+    static vector<unique_ptr<Shard>>& registry() {
+      static vector<unique_ptr<Shard>> shards;
+      return shards;
+    }
+
+    // Zeroed shards of exited threads, handed to the next thread that records
+    static vector<Shard*>& spare() {
+      static vector<Shard*> shards;
+      return shards;
+    }
+
+    // Totals of the threads whose shards were recycled
+    static Snapshot& retired() {
+      static Snapshot totals;
+      return totals;
+    }
+
+    /**
+     * @class Release
+     * @brief Returns a thread's shard to the free list when the thread exits
+     */
+    class Release {
+      public:
+        explicit Release(Shard*& owner) : owner(owner) {}
+        ~Release() {
+          lock_guard<mutex> guard(registryLock());
+          mergeShard(retired(), *owner);
+          clearShard(*owner);
+          spare().push_back(owner);
+          owner = nullptr;
+        }
+        Release(const Release&) = delete;
+        Release& operator=(const Release&) = delete;
+
+      private:
+        Shard*& owner;
+    };
+
+    static Shard& shard() {
+      // A trivially destructible pointer, so a late recording in another
+      // thread_local destructor leases a shard that just is never recycled
+      thread_local Shard* own = nullptr;
+      if (own == nullptr) {
+        {
+          lock_guard<mutex> guard(registryLock());
+          if (spare().empty()) {
+            registry().push_back(make_unique<Shard>());
+            own = registry().back().get();
+          } else {
+            own = spare().back();
+            spare().pop_back();
+          }
+        }
+        thread_local Release release(own);
+      }
+      return *own;
+    }
+
+    // Adds a shard's totals to a snapshot; the caller holds registryLock()
+    static void mergeShard(Snapshot& merged, const Shard& shard) {
+      for (size_t c = 0; c < COUNTER_COUNT; c++) merged.counters[c] += shard.counters[c].load(memory_order_relaxed);
+      for (size_t t = 0; t < TIMER_COUNT; t++) {
+        const Shard::Histogram& source = shard.timers[t];
+        Snapshot::Histogram& target = merged.timers[t];
+        target.count += source.count.load(memory_order_relaxed);
+        target.sumNanos += source.sumNanos.load(memory_order_relaxed);
+        target.maxNanos = max(target.maxNanos, source.maxNanos.load(memory_order_relaxed));
+        for (size_t b = 0; b < BUCKET_COUNT; b++) target.buckets[b] += source.buckets[b].load(memory_order_relaxed);
+      }
+    }
+
+    // Zeroes a shard whose thread has exited, before another thread reuses it
+    static void clearShard(Shard& shard) {
+      for (atomic<uint64_t>& counter : shard.counters) counter.store(0, memory_order_relaxed);
+      for (Shard::Histogram& histogram : shard.timers) {
+        histogram.count.store(0, memory_order_relaxed);
+        histogram.sumNanos.store(0, memory_order_relaxed);
+        histogram.maxNanos.store(0, memory_order_relaxed);
+        for (atomic<uint64_t>& bucket : histogram.buckets) bucket.store(0, memory_order_relaxed);
+      }
+    }
+
+    // Single-writer increment: a plain load and store, no locked read-modify-write
+    static void bump(atomic<uint64_t>& value, uint64_t amount) {
+      value.store(value.load(memory_order_relaxed) + amount, memory_order_relaxed);
+    }
+#endif
+};
+
+// ================================================== ARENA CLASSES ==================================================
+/**
+ * @class Arena
+ * @brief Monotonic scratch memory for the temporaries of one session or batch
+ *
+ * Hands out memory from an inline buffer, falling back to the heap only
+ * once that is used up. Nothing is freed individually; reset() reclaims
+ * everything at once, at a point where the owner knows no temporary is
+ * still alive (e.g. the top of a menu loop, or the end of a command).
+ * In steady state an operation therefore does no heap allocation.
+ */
+class Arena {
+  public:
+    static constexpr size_t INLINE_BYTES = 4096;
+
+    Arena() : memory(storage, sizeof(storage)) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // @brief Returns the memory resource to build pmr containers with.
+    pmr::memory_resource* resource() { return &memory; }
+
+    // @brief Reclaims every allocation; all memory handed out so far becomes invalid.
+    void reset() { memory.release(); }
+
+  private:
+    alignas(max_align_t) byte storage[INLINE_BYTES];
+    pmr::monotonic_buffer_resource memory;
+};
+
+/**
+ * @class FramePool
+ * @brief Per-thread free lists that recycle coroutine frames
+ *
+ * Every prompt and module run is a coroutine, so a menu round trip would
+ * otherwise allocate and free a dozen frames. Frames are grouped into
+ * 64-byte size classes; a freed frame goes on its thread's list for that
+ * class and is handed to the next coroutine of the same size. A frame
+ * may be freed on another thread than the one that created it (a server
+ * worker resuming a session), which only moves it between lists.
+ */
+class FramePool {
+  public:
+    // @brief Returns memory for a coroutine frame of size bytes.
+    static void* allocate(size_t size) {
+      size_t sizeClass = classOf(size);
+      if (sizeClass >= CLASS_COUNT) return ::operator new(size);
+
+      FreeLists& lists = freeLists();
+      if (FreeFrame* frame = lists.heads[sizeClass]) {
+        lists.heads[sizeClass] = frame->next;
+        lists.lengths[sizeClass]--;
+        return frame;
+      }
+      return ::operator new((sizeClass + 1) * GRANULE);
+    }
+
+    // @brief Returns a frame from allocate() with the same size.
+    static void release(void* frame, size_t size) {
+      size_t sizeClass = classOf(size);
+      if (sizeClass >= CLASS_COUNT) {
+        ::operator delete(frame);
+        return;
+      }
+
+      FreeLists& lists = freeLists();
+      if (lists.lengths[sizeClass] == MAX_CACHED) {
+        ::operator delete(frame);
+        return;
+      }
+      lists.heads[sizeClass] = new (frame) FreeFrame{lists.heads[sizeClass]};
+      lists.lengths[sizeClass]++;
+    }
+
+  private:
+    static constexpr size_t GRANULE = 64;        // Bytes per size class
+    static constexpr size_t CLASS_COUNT = 32;    // Frames up to 2 KiB are recycled
+    static constexpr size_t MAX_CACHED = 256;    // Free frames kept per class and thread
+
+    struct FreeFrame {
+      FreeFrame* next;
+    };
+
+    struct FreeLists {
+      FreeFrame* heads[CLASS_COUNT] = {};
+      size_t lengths[CLASS_COUNT] = {};
+
+      ~FreeLists() {
+        for (FreeFrame* head : heads) {
+          while (head) ::operator delete(exchange(head, head->next));
+        }
+      }
+    };
+
+    static size_t classOf(size_t size) { return (size - 1) / GRANULE; }
+
+    static FreeLists& freeLists() {
+      thread_local FreeLists lists;
+      return lists;
+    }
+};
+
+// ================================================== SESSION ENGINE CLASSES ==================================================
+/**
+ * @struct TaskResult
+ * @brief Storage for the value a Task hands back to its awaiter
+ */
+template < typename T >
+struct TaskResult {
+  optional<T> value;
+
+  void return_value(T result) { value = move(result); }
+  T take() { return move(*value); }
+};
+
+template <>
+struct TaskResult<void> {
+  void return_void() {}
+  void take() {}
+};
+
+/**
+ * @class Task
+ * @brief Lazily started coroutine that resumes its awaiter when it finishes
+ * @tparam T The co_return type (void by default)
+ *
+ * Awaiting a Task starts it; when it completes, control transfers
+ * straight back to the awaiting coroutine, so arbitrarily deep handler
+ * chains never grow the native stack. Destroying a Task destroys its
+ * frame, and with it every Task the frame is still awaiting.
+ */
+template < typename T = void >
+class Task {
+  public:
+    struct promise_type : TaskResult<T> {
+      coroutine_handle<> continuation = noop_coroutine();
+
+      // Frames come from the calling thread's FramePool rather than straight from the heap
+      static void* operator new(size_t size) { return FramePool::allocate(size); }
+      static void operator delete(void* frame, size_t size) { FramePool::release(frame, size); }
+
+      Task get_return_object() { return Task(coroutine_handle<promise_type>::from_promise(*this)); }
+      suspend_always initial_suspend() noexcept { return {}; }
+      void unhandled_exception() { terminate(); }
+
+      auto final_suspend() noexcept {
+        struct ResumeAwaiter {
+          bool await_ready() noexcept { return false; }
+          coroutine_handle<> await_suspend(coroutine_handle<promise_type> finished) noexcept { return finished.promise().continuation; }
+          void await_resume() noexcept {}
+        };
+        return ResumeAwaiter{};
+      }
+    };
+
+    Task(Task&& other) noexcept : handle(exchange(other.handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+      if (this != &other) {
+        if (handle) handle.destroy();
+        handle = exchange(other.handle, nullptr);
+      }
+      return *this;
+    }
+    ~Task() { if (handle) handle.destroy(); }
+
+    // @brief Runs a top-level task until its first suspension.
+    void start() { handle.resume(); }
+
+    // @brief Returns true once the coroutine has returned.
+    bool done() const { return handle.done(); }
+
+    bool await_ready() const noexcept { return false; }
+    coroutine_handle<> await_suspend(coroutine_handle<> awaiting) noexcept {
+      handle.promise().continuation = awaiting;
+      return handle;
+    }
+    T await_resume() { return handle.promise().take(); }
+
+  private:
+    coroutine_handle<promise_type> handle;
+
+    explicit Task(coroutine_handle<promise_type> handle) : handle(handle) {}
+};
+
+/**
+ * @class Session
+ * @brief Input and output of one interactive conversation, driven by a frontend
+ *
+ * Handlers write to out and extract from in exactly as they would with
+ * cout and cin, but co_await token(), line() or character() first. If the
+ * bytes that extraction needs have not arrived yet, the handler suspends
+ * and the frontend gets control back; feed() resumes it once they have.
+ * One thread can therefore hold any number of sessions that are waiting
+ * on their users.
+ */
+class Session {
+  private:
+    // Get area over the bytes fed so far; reports EOF instead of blocking
+    class InputBuffer : public streambuf {
+      public:
+        void append(string_view bytes) {
+          pending.erase(0, static_cast<size_t>(gptr() - eback()));
+          pending.append(bytes.data(), bytes.size());
+          setg(pending.data(), pending.data(), pending.data() + pending.size());
+        }
+
+        // @brief Returns the bytes not yet extracted.
+        string_view unread() const { return string_view(gptr(), static_cast<size_t>(egptr() - gptr())); }
+
+      protected:
+        int_type underflow() override { return traits_type::eof(); }
+
+      private:
+        string pending;
+    };
+
+    enum class Need { Nothing, Token, Line, Character };
+
+    InputBuffer buffer;
+    Arena scratch;
+    Need need = Need::Nothing;
+    coroutine_handle<> waiting;
+    optional<Task<>> root;
+    bool closed = false;
+
+    // True if in can satisfy the given extraction without running dry
+    bool ready(Need what) const {
+      string_view unread = buffer.unread();
+      switch (what) {
+        case Need::Token: {
+          // A whole whitespace-delimited token, as operator>> reads it
+          size_t start = 0;
+          while (start < unread.size() && isspace(static_cast<unsigned char>(unread[start]))) start++;
+          if (start == unread.size()) return false;
+          while (start < unread.size() && !isspace(static_cast<unsigned char>(unread[start]))) start++;
+          return start < unread.size() || closed;
+        }
+        case Need::Line:
+          return unread.find('\n') != string_view::npos || closed;
+        case Need::Character:
+          return !unread.empty() || closed;
+        default:
+          return true;
+      }
+    }
+
+    // Resumes the suspended handler if its input has arrived
+    void pump() {
+      if (waiting && ready(need)) {
+        need = Need::Nothing;
+        exchange(waiting, nullptr).resume();
+      }
+    }
+
+    struct InputAwaiter {
+      Session& session;
+      Need what;
+
+      bool await_ready() const { return session.ready(what); }
+      void await_suspend(coroutine_handle<> handler) {
+        session.need = what;
+        session.waiting = handler;
+      }
+      void await_resume() const {}
+    };
+
+  public:
+    istream in;     // Extract from this after awaiting the matching input
+    ostream& out;   // Everything the handlers display
+
+    /**
+     * @brief Creates a session that writes to the given stream
+     * @param out Session output; its format flags persist for the session, as cout's do
+     */
+    explicit Session(ostream& out) : in(&buffer), out(out) {}
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    /**
+     * @brief Runs the session's top-level handler until it first needs input
+     * @param handler Typically Program::runSession(*this)
+     */
+    void start(Task<> handler) {
+      root.emplace(move(handler));
+      root->start();
+    }
+
+    // @brief Delivers bytes typed by the user and resumes the handler if they suffice.
+    void feed(string_view bytes) {
+      buffer.append(bytes);
+      pump();
+    }
+
+    // @brief Marks the end of input; a handler that needs more than is left is abandoned.
+    void close() {
+      closed = true;
+      pump();
+    }
+
+    /**
+     * @brief Returns true once the handler has returned or can never continue
+     */
+    bool finished() const {
+      return !root || root->done() || (closed && waiting && !ready(need));
+    }
+
+    /**
+     * @brief Returns the session's scratch arena for prompts
+     *
+     * Program::runSession() resets it at every main menu, so a module may
+     * keep arena memory across awaits until it returns to the menu. Since
+     * nothing is freed before then, work a module repeats in its own loop
+     * (e.g. each conversion) uses an Arena of its own instead.
+     */
+    Arena& arena() { return scratch; }
+
+    // @brief Waits until in holds a complete whitespace-delimited token.
+    InputAwaiter token() { return {*this, Need::Token}; }
+
+    // @brief Waits until in holds the rest of the current line, newline included.
+    InputAwaiter line() { return {*this, Need::Line}; }
+
+    // @brief Waits until in holds at least one more character.
+    InputAwaiter character() { return {*this, Need::Character}; }
+};
+
+// ================================================== TEXT FORMATTER CLASS ======================================================
+/**
+ * @class TextFormatter
+ * @brief Builds fixed-layout text in a reusable buffer without iostreams
+ *
+ * Produces the same bytes as the iostream manipulators it replaces:
+ * right() and left() pad like setw() with right or left (counting bytes,
+ * so UTF-8 text is padded exactly as setw() pads it), and fixed() prints
+ * like fixed << setprecision(). Numbers use to_chars and never allocate.
+ */
+class TextFormatter {
+  public:
+    // UTF-8 currency sign used in the tables
+    static constexpr string_view PESO_SIGN = "₱";
+
+    // @brief Appends text as is.
+    TextFormatter& text(string_view value) {
+      buffer.append(value.data(), value.size());
+      return *this;
+    }
+
+    // @brief Appends text, left-aligned in a field of width bytes (setw(width) << left).
+    TextFormatter& left(string_view value, size_t width) {
+      size_t start = buffer.size();
+      return text(value).padTo(start, width);
+    }
+
+    // @brief Appends text, right-aligned in a field of width bytes (setw(width) << right).
+    TextFormatter& right(string_view value, size_t width) {
+      if (value.size() < width) buffer.append(width - value.size(), ' ');
+      return text(value);
+    }
+
+    // @brief Appends value with precision decimals (fixed << setprecision(precision)).
+    TextFormatter& fixed(double value, int precision) {
+      char number[FIXED_CAPACITY];
+      to_chars_result result = to_chars(number, number + sizeof(number), value, chars_format::fixed, precision);
+      buffer.append(number, result.ptr);
+      return *this;
+    }
+
+    // @brief Returns the current length, to pad what follows with padTo() or padColumnsTo().
+    size_t mark() const { return buffer.size(); }
+
+    // @brief Pads everything appended since start with spaces to width bytes.
+    TextFormatter& padTo(size_t start, size_t width) {
+      size_t length = buffer.size() - start;
+      if (length < width) buffer.append(width - length, ' ');
+      return *this;
+    }
+
+    // @brief Pads everything appended since start with spaces to width UTF-8 code points.
+    TextFormatter& padColumnsTo(size_t start, size_t width) {
+      size_t columns = 0;
+      for (size_t i = start; i < buffer.size(); i++) columns += (static_cast<unsigned char>(buffer[i]) & 0xC0) != 0x80;
+      if (columns < width) buffer.append(width - columns, ' ');
+      return *this;
+    }
+
+    // @brief Returns the text built so far.
+    string_view view() const { return buffer; }
+
+    // @brief Empties the buffer, keeping its capacity.
+    void clear() { buffer.clear(); }
+
+    // @brief Writes the text to out and empties the buffer, keeping its capacity.
+    void writeTo(ostream& out) {
+      out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+      buffer.clear();
+    }
+
+  private:
+    // Fits any double in fixed notation with up to 8 decimals (DBL_MAX has 309 digits)
+    static constexpr size_t FIXED_CAPACITY = 512;
+
+    string buffer;
+};
+
 // ========================================================= UI CLASS =========================================================
 /**
  * @class UI
@@ -17,14 +801,24 @@ using namespace std;
  * to maintain consistent formatting throughout the application.
  */
 class UI {
+  private:
+    static constexpr string_view SEPARATOR = "---------------------------------------------\n";
+    static_assert(SEPARATOR.size() == 45 + 1, "separator is 45 dashes and a newline");
+
   public:
     /**
      * @brief Displays a formatted header with the given title
+     * @param out The session output to write to
      * @param title The title to display in the header
      * 
      */
-    static void header(const string &title) {
-      cout << "\n>>> ===== " << title << " ===== <<<\n";
+    static void header(ostream& out, string_view title) {
+      out << "\n>>> ===== " << title << " ===== <<<\n";
+    }
+
+    // @brief header() into a formatter, for text that is built before it is shown.
+    static void header(TextFormatter& out, string_view title) {
+      out.text("\n>>> ===== ").text(title).text(" ===== <<<\n");
     }
 
     /**
@@ -33,10 +827,12 @@ class UI {
      * Creates a 45-character line using '-' characters
      * to visually separate sections of the interface.
      */
-    static void line() {
-      cout << string(45, '-') << "\n";
+    static void line(ostream& out) {
+      out.write(SEPARATOR.data(), static_cast<streamsize>(SEPARATOR.size()));
     }
 
+    static void line(TextFormatter& out) { out.text(SEPARATOR); }
+
     /**
      * @brief Displays a farewell or closing message to the user.
      * 
@@ -44,19 +840,110 @@ class UI {
      *
      * @param message The message to display.
    */
-    static void goodbyeMessage(const string &message) {
-      cout << message;
+    static void goodbyeMessage(ostream& out, string_view message) {
+      out << message;
     }
 
-    // @brief Pauses execution until the user presses Enter once.
-    static void pauseBuffer() {
-      cout << "\n>>> Press Enter to continue...";
-      cin.ignore(numeric_limits<streamsize>::max(), '\n');
-      cin.get();
+    // @brief Pauses the session until the user presses Enter once.
+    static Task<> pauseBuffer(Session& session) {
+      session.out << "\n>>> Press Enter to continue...";
+      co_await session.line();
+      session.in.ignore(numeric_limits<streamsize>::max(), '\n');
+      co_await session.character();
+      session.in.get();
     }
 };
 
 // ================================================== INPUT VALIDATOR CLASS ======================================================
+/**
+ * @struct StaticText
+ * @brief Fixed-capacity character buffer that can be filled in constant expressions
+ * @tparam Capacity Maximum length; overflowing it is a compile error when built at compile time
+ */
+template < size_t Capacity >
+struct StaticText {
+  char data[Capacity] = {};
+  size_t size = 0;
+
+  constexpr StaticText& append(string_view text) {
+    for (char c : text) data[size++] = c;
+    return *this;
+  }
+
+  constexpr StaticText& append(long long value) {
+    char digits[20] = {};
+    size_t count = 0;
+    unsigned long long magnitude = value < 0 ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+    do {
+      digits[count++] = static_cast<char>('0' + magnitude % 10);
+      magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) data[size++] = '-';
+    while (count > 0) data[size++] = digits[--count];
+    return *this;
+  }
+
+  constexpr string_view view() const { return string_view(data, size); }
+};
+
+/**
+ * @struct ValueRange
+ * @brief Compile-time bounds of a validated value, with their error texts
+ * @tparam Min Smallest accepted value (inclusive)
+ * @tparam Max Largest accepted value (inclusive)
+ *
+ * contains() is a pair of comparisons joined without a branch, so it
+ * folds into batch loops. The messages are built at compile time and
+ * read exactly like the runtime validators' (integral bounds below a
+ * million print the same through cout and through %g).
+ */
+template < auto Min, auto Max >
+struct ValueRange {
+  static_assert(is_integral_v<decltype(Min)> && is_integral_v<decltype(Max)>, "ValueRange bounds must be integral constants");
+  static_assert(Min <= Max, "ValueRange needs Min <= Max");
+  static_assert(Min > -1000000 && Max < 1000000, "bounds beyond six digits print in exponent form through cout");
+
+  static constexpr long long MIN = Min;
+  static constexpr long long MAX = Max;
+
+  // @brief Returns true if value lies in [MIN, MAX]; false for NaN.
+  template < typename T >
+  static constexpr bool contains(T value) {
+    return (value >= static_cast<T>(MIN)) & (value <= static_cast<T>(MAX));
+  }
+
+  // " must be MIN-MAX", appended to a field label by FieldReader::nextInt()
+  static constexpr StaticText<48> CHOICE_BOUNDS = [] {
+    StaticText<48> text;
+    text.append(" must be ").append(MIN).append("-").append(MAX);
+    return text;
+  }();
+
+  // " must be between MIN and MAX", appended to a field label by FieldReader::nextDouble()
+  static constexpr StaticText<64> VALUE_BOUNDS = [] {
+    StaticText<64> text;
+    text.append(" must be between ").append(MIN).append(" and ").append(MAX);
+    return text;
+  }();
+
+  // The retry message of getValidatedChoice()
+  static constexpr StaticText<80> CHOICE_ERROR = [] {
+    StaticText<80> text;
+    text.append("[ERROR] Choice must be ").append(MIN).append("-").append(MAX).append(". Try again.\n");
+    return text;
+  }();
+
+  // The retry message of getValidatedDouble()
+  static constexpr StaticText<96> VALUE_ERROR = [] {
+    StaticText<96> text;
+    text.append("[ERROR] Value must be between ").append(MIN).append(" and ").append(MAX).append(". Try again.\n");
+    return text;
+  }();
+};
+
+static_assert(ValueRange<0, 100>::VALUE_BOUNDS.view() == " must be between 0 and 100");
+static_assert(ValueRange<1, 20>::contains(20) && !ValueRange<100, 100000>::contains(99.99));
+
 /**
  * @class InputValidator
  * @brief Handles all user input validation with type and range checking
@@ -69,28 +956,34 @@ class InputValidator {
     /**
      * @brief Template method to get validated input of any type
      * @tparam T The data type to read (int, double, etc.)
+     * @param session The session to prompt and read from
      * @param prompt The message to display to the user
      * @param var Reference to store the validated input
+     * @param promptSuffix Displayed right after prompt, so callers need not concatenate
      * 
      * Continuously prompts until valid input is received.
      * Clears error flags and invalid input from the stream.
      */
     template < typename T >
-    static void getValidated(const string& prompt, T& var) {
+    static Task<> getValidated(Session& session, string_view prompt, T& var, string_view promptSuffix = {}) {
       while (true) {
-        cout << prompt;
-        cin >> var;
+        session.out << prompt << promptSuffix;
+        co_await session.token();
+        session.in >> var;
 
-        if (!cin.fail()) break;
+        if (!session.in.fail()) break;
 
-        cout << "\n[ERROR] Invalid input! Try again.\n";
-        cin.clear();
-        cin.ignore(numeric_limits < streamsize > ::max(), '\n');
+        session.out << "\n[ERROR] Invalid input! Try again.\n";
+        Metrics::count(Counter::ValidatorRetries);
+        session.in.clear();
+        co_await session.line();
+        session.in.ignore(numeric_limits < streamsize > ::max(), '\n');
       }
     }
 
     /**
      * @brief Gets a validated integer choice within a specified range
+     * @param session The session to prompt and read from
      * @param prompt The prompt message to display
      * @param min Minimum acceptable value (inclusive)
      * @param max Maximum acceptable value (inclusive)
@@ -98,20 +991,23 @@ class InputValidator {
      * 
      * Used for menu selections where input must be within a specific range.
      */
-    static int getValidatedChoice(const string& prompt, int min, int max) {
+    static Task<int> getValidatedChoice(Session& session, string_view prompt, int min, int max) {
       int choice;
 
       do {
-        getValidated(prompt, choice);
-        if (choice < min || choice > max)
-          cout << "[ERROR] Choice must be " << min << "-" << max << ". Try again.\n";
+        co_await getValidated(session, prompt, choice);
+        if (choice < min || choice > max) {
+          session.out << "[ERROR] Choice must be " << min << "-" << max << ". Try again.\n";
+          Metrics::count(Counter::ValidatorRetries);
+        }
       } while (choice < min || choice > max);
 
-      return choice;
+      co_return choice;
     }
 
     /**
      * @brief Gets a validated double value within a specified range
+     * @param session The session to prompt and read from
      * @param prompt The prompt message to display
      * @param min Minimum acceptable value (inclusive)
      * @param max Maximum acceptable value (inclusive)
@@ -119,548 +1015,6108 @@ class InputValidator {
      * 
      * Used for numeric inputs like grades or monetary amounts.
      */
-    static double getValidatedDouble(const string & prompt, double min, double max) {
+    static Task<double> getValidatedDouble(Session& session, string_view prompt, double min, double max) {
       double value;
 
       do {
-        getValidated(prompt, value);
-        if (value < min || value > max)
-          cout << "[ERROR] Value must be between " << min << " and " << max << ". Try again.\n";
+        co_await getValidated(session, prompt, value);
+        if (value < min || value > max) {
+          session.out << "[ERROR] Value must be between " << min << " and " << max << ". Try again.\n";
+          Metrics::count(Counter::ValidatorRetries);
+        }
       } while (value < min || value > max);
 
-      return value;
+      co_return value;
     }
 
     /**
-     * @brief Gets a validated yes/no response from the user.
-     * 
+     * @brief getValidatedChoice() with the bounds fixed at compile time
+     * @tparam Min Minimum acceptable value (inclusive)
+     * @tparam Max Maximum acceptable value (inclusive)
+     *
+     * Same prompts and messages; the message is a compile-time constant.
+     */
+    template < auto Min, auto Max >
+    static Task<int> getValidatedChoice(Session& session, string_view prompt) {
+      using Range = ValueRange<Min, Max>;
+      int choice;
+
+      while (true) {
+        co_await getValidated(session, prompt, choice);
+        if (Range::contains(choice)) co_return choice;
+        session.out << Range::CHOICE_ERROR.view();
+        Metrics::count(Counter::ValidatorRetries);
+      }
+    }
+
+    /**
+     * @brief getValidatedDouble() with the bounds fixed at compile time
+     * @tparam Min Minimum acceptable value (inclusive)
+     * @tparam Max Maximum acceptable value (inclusive)
+     */
+    template < auto Min, auto Max >
+    static Task<double> getValidatedDouble(Session& session, string_view prompt) {
+      using Range = ValueRange<Min, Max>;
+      double value;
+
+      while (true) {
+        co_await getValidated(session, prompt, value);
+        if (!(value < Range::MIN || value > Range::MAX)) co_return value;   // NaN passes, as in the runtime version
+
+        // The constant text matches default formatting; earlier screens may have left the stream fixed
+        if ((session.out.flags() & ios::floatfield) == ios::fmtflags() && session.out.precision() >= 6) {
+          session.out << Range::VALUE_ERROR.view();
+        } else {
+          session.out << "[ERROR] Value must be between " << static_cast<double>(Range::MIN)
+                      << " and " << static_cast<double>(Range::MAX) << ". Try again.\n";
+        }
+        Metrics::count(Counter::ValidatorRetries);
+      }
+    }
+
+    /**
+     * @brief Gets a validated yes/no response from the user.
+     * 
      * Uses the generic getValidated() template to safely read a string input,
      * then normalizes it to lowercase for case-insensitive comparison.
      * Accepts both short and long forms ("y" / "yes", "n" / "no").
      * 
      * The function loops until a valid yes/no response is entered.
      * 
+     * @param session The session to prompt and read from.
      * @param prompt The message to display to the user.
      * @return true  If the user enters "y" or "yes".
      * @return false If the user enters "n" or "no".
      */
-    static bool getValidatedYesNo(const string& prompt) {
-      string input;
+    static Task<bool> getValidatedYesNo(Session& session, string_view prompt) {
+      string input;   // Reused across attempts
 
       do {
-        getValidated(prompt + " (y/n): ", input);
-
-        // convert to lowercase
-        for (char& c : input) c = tolower(c);
+        co_await getValidated(session, prompt, input, " (y/n): ");
 
-        if (input == "y" || input == "yes") return true;
-        if (input == "n" || input == "no") return false;
+        // compare case-insensitively, without lowercasing a copy
+        optional<bool> answer = matchYesNo(input);
+        if (answer) co_return *answer;
 
-        cout << "[ERROR] Please type 'y' or 'n'.\n";
+        session.out << "[ERROR] Please type 'y' or 'n'.\n";
+        Metrics::count(Counter::ValidatorRetries);
 
         } while (true);
     }
-};
 
-// ================================================== VIRTUAL STUDENT INFO CLASS =================================================
-/**
- * @class VirtualStudentInfo
- * @brief Displays static student information
- * 
- * This class provides a simple interface to show predefined
- * student details when selected from the main menu.
- */
-class VirtualStudentInfo {
-  public:
+    // @brief Outcome of validating caller-supplied text.
+    enum class ParseResult { Valid, NotANumber, OutOfRange };
+
     /**
-     * @brief Runs the Virtual Student Info activity
-     * 
-     * Displays a formatted header followed by the student's
-     * personal and academic information.
+     * @brief Parses text that must consist of exactly one number
+     * @tparam T int, double, int64_t, ...
+     * @param text The characters to parse (the caller trims blanks)
+     * @param value Receives the number
+     * @return false if text is empty, not a number, or has trailing characters
+     *
+     * Uses from_chars, so there is no stream, locale or heap allocation.
+     * A leading '+' is accepted like istream extraction does.
      */
-    void runStudentInfo() {
-      UI::header("Virtual Student Info");
-
-      // Display static student information
-      cout << "Name: Alberto Jr Deniros\n"
-           << "Section and Course: BSCS 1-A\n"
-           << "AGE: 23\n"
-           << "GENDER: MALE\n"
-           << "CODING DEVICES: Desktop Computer\n"
-      ;
-      
-      UI::pauseBuffer();
+    template < typename T >
+    static bool parse(string_view text, T& value) {
+      if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+      if (text.empty()) return false;
+      auto [end, ec] = from_chars(text.data(), text.data() + text.size(), value);
+      return ec == errc() && end == text.data() + text.size();
     }
-};
 
-// ================================================== STUDENT GRADE EVALUATOR CLASS =================================================
-/**
- * @class StudentGradeEvaluator
- * @brief Evaluates student grades and determines pass/fail status
- * 
- * This class collects four grades from the user, calculates the average,
- * and compares it against a passing threshold to determine the result.
- */
-class StudentGradeEvaluator {
-  private:
     /**
-     * @struct Grade
-     * @brief Represents a single grade with name and value
+     * @brief Allocation-free counterpart of getValidatedChoice()
+     * @param text Candidate input, e.g. one field of a batch line
+     * @param min Minimum acceptable value (inclusive)
+     * @param max Maximum acceptable value (inclusive)
+     * @param choice Receives the parsed value (also when it is out of range)
      */
-    struct Grade {
-      string name;    // Name of the grading period (e.g., "Prelim")
-      double value;   // Numerical grade value (0-100)
-    };
+    static ParseResult parseChoice(string_view text, int min, int max, int& choice) {
+      if (!parse(text, choice)) return ParseResult::NotANumber;
+      return (choice < min || choice > max) ? ParseResult::OutOfRange : ParseResult::Valid;
+    }
 
-  public:
     /**
-     * @brief Runs the Student Grade Evaluator activity
-     * 
-     * Prompts for four grades (Prelim, Midterm, PreFinal, Final),
-     * calculates the average, and displays pass/fail status.
+     * @brief Allocation-free counterpart of getValidatedDouble()
+     * @param text Candidate input, e.g. one field of a batch line
+     * @param min Minimum acceptable value (inclusive)
+     * @param max Maximum acceptable value (inclusive)
+     * @param value Receives the parsed value (also when it is out of range)
+     *
+     * NaN counts as out of range, since it compares false against both bounds.
      */
-    void runStudentGradeEvaluator() {
-      UI::header("Student Grade Evaluator");
+    static ParseResult parseDouble(string_view text, double min, double max, double& value) {
+      if (!parse(text, value)) return ParseResult::NotANumber;
+      return (value >= min && value <= max) ? ParseResult::Valid : ParseResult::OutOfRange;
+    }
 
-      const int NUMBER_OF_GRADES = 4;      // Total number of grades to collect
-      const int PASSING_GRADE = 80;        // Minimum average required to pass
-      const int MIN_GRADE = 0;             // Min Grade required
-      const int MAX_GRADE = 100;           // Max Grade required
+    // @brief parseChoice() with the bounds fixed at compile time.
+    template < auto Min, auto Max >
+    static ParseResult parseChoice(string_view text, int& choice) {
+      if (!parse(text, choice)) return ParseResult::NotANumber;
+      return ValueRange<Min, Max>::contains(choice) ? ParseResult::Valid : ParseResult::OutOfRange;
+    }
 
-      // Initialize grade entries with names and default values
-      Grade gradeList[NUMBER_OF_GRADES] = {
-        {"Prelim", 0},
-        {"Midterm", 0},
-        {"PreFinal", 0},
-        {"Final", 0}
-      };
+    // @brief parseDouble() with the bounds fixed at compile time.
+    template < auto Min, auto Max >
+    static ParseResult parseDouble(string_view text, double& value) {
+      if (!parse(text, value)) return ParseResult::NotANumber;
+      return ValueRange<Min, Max>::contains(value) ? ParseResult::Valid : ParseResult::OutOfRange;
+    }
 
-      double sum = 0; // Accumulator for grade total
+    /**
+     * @brief Checks a whole column against compile-time bounds in one vectorized pass
+     * @tparam Min Smallest accepted value
+     * @tparam Max Largest accepted value
+     * @param values The column to check
+     * @param validBits Receives bit (i % 64) of word (i / 64) set for each value in range;
+     *                  needs room for (values.size() + 63) / 64 words
+     * @return The number of values out of range (NaN included)
+     *
+     * Compares AVX2 (4 values) or NEON (2 values) lanes against both bounds
+     * and packs the resulting masks, so there is no branch per value.
+     */
+    template < auto Min, auto Max >
+    static size_t validateColumn(span<const double> values, uint64_t* validBits) {
+      using Range = ValueRange<Min, Max>;
+      const size_t count = values.size();
+      const double* data = values.data();
+      size_t valid = 0;
 
-      // Collect and validate each grade
-      for (int i = 0; i < NUMBER_OF_GRADES; i++) {
-        gradeList[i].value = InputValidator::getValidatedDouble(
-          "Enter " + gradeList[i].name + " Grade: ", MIN_GRADE, MAX_GRADE
-        );
-        sum += gradeList[i].value;
+      for (size_t word = 0; word * 64 < count; word++) {
+        const size_t start = word * 64;
+        const size_t end = min(count, start + 64);
+        uint64_t bits = 0;
+        size_t i = start;
+#if defined(__AVX2__)
+        const __m256d low = _mm256_set1_pd(static_cast<double>(Range::MIN));
+        const __m256d high = _mm256_set1_pd(static_cast<double>(Range::MAX));
+        for (; i + 4 <= end; i += 4) {
+          __m256d value = _mm256_loadu_pd(data + i);
+          __m256d inRange = _mm256_and_pd(_mm256_cmp_pd(value, low, _CMP_GE_OQ), _mm256_cmp_pd(value, high, _CMP_LE_OQ));
+          bits |= static_cast<uint64_t>(_mm256_movemask_pd(inRange)) << (i - start);
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        const float64x2_t low = vdupq_n_f64(static_cast<double>(Range::MIN));
+        const float64x2_t high = vdupq_n_f64(static_cast<double>(Range::MAX));
+        for (; i + 2 <= end; i += 2) {
+          float64x2_t value = vld1q_f64(data + i);
+          uint64x2_t inRange = vandq_u64(vcgeq_f64(value, low), vcleq_f64(value, high));
+          bits |= ((vgetq_lane_u64(inRange, 0) & 1) | ((vgetq_lane_u64(inRange, 1) & 1) << 1)) << (i - start);
+        }
+#endif
+        for (; i < end; i++) bits |= static_cast<uint64_t>(Range::contains(data[i])) << (i - start);
+
+        validBits[word] = bits;
+        valid += static_cast<size_t>(popcount(bits));
       }
+      return count - valid;
+    }
 
-      // Calculate average grade
-      double average = sum / NUMBER_OF_GRADES;
+    // @brief Compares two strings ignoring ASCII case.
+    static constexpr bool equalsIgnoreCase(string_view text, string_view expected) {
+      if (text.size() != expected.size()) return false;
+      for (size_t i = 0; i < text.size(); i++) {
+        if (lowerAscii(text[i]) != lowerAscii(expected[i])) return false;
+      }
+      return true;
+    }
+
+    /**
+     * @brief Case-insensitive yes/no matcher shared by every yes/no prompt
+     * @return true for "y"/"yes", false for "n"/"no", empty for anything else
+     */
+    static constexpr optional<bool> matchYesNo(string_view text) {
+      if (equalsIgnoreCase(text, "y") || equalsIgnoreCase(text, "yes")) return true;
+      if (equalsIgnoreCase(text, "n") || equalsIgnoreCase(text, "no")) return false;
+      return nullopt;
+    }
 
-      // Display results with formatting
-      UI::line();
-      cout << "Passing grade: " << PASSING_GRADE << "\n";
-      cout << "Your average: " << average << "\n";
-      cout << "REMARKS: ";
+  private:
+    static constexpr char lowerAscii(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+};
 
-      // Determine and display pass/fail status
-      if (average >= PASSING_GRADE) {
-        UI::header("PASADO KA BOI!!");
-      } else {
-        UI::header("BAGSAK KA BOI!!");
-      }
-      UI::line();
+static_assert(InputValidator::matchYesNo("YeS") == true && InputValidator::matchYesNo("n") == false);
+static_assert(!InputValidator::matchYesNo("yess").has_value());
 
-      UI::pauseBuffer();
-    };
+// ================================================== FIXED POINT MONEY ======================================================
+/**
+ * @enum RoundingMode
+ * @brief How a fixed-point result is rounded to its last kept digit
+ */
+enum class RoundingMode {
+  HalfUp,     // Ties round away from zero (0.125 -> 0.13)
+  HalfEven,   // Ties round to the even digit (0.125 -> 0.12, 0.135 -> 0.14)
+  Down        // Extra digits are dropped (0.129 -> 0.12)
 };
 
-// ================================================== TRIANGLE ACTIVITY CLASS =================================================
 /**
- * @class TriangleActivity
- * @brief Generates and displays triangle patterns using asterisks
- * 
- * This class provides an interactive interface for creating
- * right-aligned and inverted triangle patterns of specified heights.
+ * @class FixedPoint
+ * @brief Exact decimal arithmetic on int64 values with an implied scale
+ *
+ * A value with D decimals is stored as value * 10^D, e.g. ₱123.45 is
+ * 12345 centavos. Parsing, division and formatting never go through a
+ * double, so results are reproducible to the last digit.
  */
-class TriangleActivity {
-  private:
+class FixedPoint {
+  public:
+    static constexpr int MAX_DECIMALS = 18;
+
+    // @brief Returns 10^decimals.
+    static constexpr int64_t scale(int decimals) {
+      int64_t result = 1;
+      for (int i = 0; i < decimals; i++) result *= 10;
+      return result;
+    }
+
     /**
-     * @brief Displays a right-aligned triangle pattern
-     * @param height The number of rows in the triangle
-     * 
-     * Example (height = 3):
-     * *
-     * **
-     * ***
+     * @brief Divides two non-negative integers with explicit rounding
+     * @param numerator Dividend (>= 0)
+     * @param denominator Divisor (> 0)
+     * @param mode Rounding applied to the remainder
      */
-    void displayRightTriangle(int height) {
-      for (int i = 0; i < height; i++) {
-        for(int j = 0; j <= i; j++) {
-          cout << "*";
+    static int64_t divide(int64_t numerator, int64_t denominator, RoundingMode mode) {
+      int64_t quotient = numerator / denominator;
+      int64_t remainder = numerator % denominator;
+      switch (mode) {
+        case RoundingMode::HalfUp:
+          if (remainder >= denominator - remainder) quotient++;
+          break;
+        case RoundingMode::HalfEven:
+          if (remainder > denominator - remainder || (remainder == denominator - remainder && (quotient & 1))) quotient++;
+          break;
+        case RoundingMode::Down:
+          break;
+      }
+      return quotient;
+    }
+
+    /**
+     * @brief Parses decimal text such as "123.456" into a scaled integer
+     * @param text Digits with an optional sign and decimal point (no exponent)
+     * @param decimals Digits kept after the point; extra digits are rounded with mode
+     * @param mode Rounding for digits beyond decimals
+     * @param value Receives the scaled value
+     * @return false if the text is not a plain decimal number or does not fit in int64
+     */
+    static bool parse(string_view text, int decimals, RoundingMode mode, int64_t& value) {
+      bool negative = !text.empty() && text.front() == '-';
+      if (!text.empty() && (text.front() == '-' || text.front() == '+')) text.remove_prefix(1);
+
+      int64_t result = 0;
+      int kept = 0;               // Fraction digits kept so far
+      bool seenPoint = false, seenDigit = false;
+      int firstDropped = -1;      // First digit beyond the kept ones
+      bool droppedNonZero = false;
+
+      for (char c : text) {
+        if (c == '.' && !seenPoint) {
+          seenPoint = true;
+          continue;
+        }
+        if (c < '0' || c > '9') return false;
+        seenDigit = true;
+
+        if (seenPoint && kept == decimals) {
+          if (firstDropped < 0) firstDropped = c - '0';
+          else droppedNonZero |= (c != '0');
+          continue;
+        }
+        if (result > (numeric_limits<int64_t>::max() - 9) / 10) return false;
+        result = result * 10 + (c - '0');
+        if (seenPoint) kept++;
+      }
+      if (!seenDigit) return false;
+
+      for (; kept < decimals; kept++) {
+        if (result > numeric_limits<int64_t>::max() / 10) return false;
+        result *= 10;
+      }
+
+      bool roundUp = false;
+      if (firstDropped >= 0) {
+        switch (mode) {
+          case RoundingMode::HalfUp:   roundUp = firstDropped >= 5; break;
+          case RoundingMode::HalfEven: roundUp = firstDropped > 5 || (firstDropped == 5 && (droppedNonZero || (result & 1))); break;
+          case RoundingMode::Down:     break;
         }
-        cout << "\n";
       }
+      if (roundUp) result++;
+
+      value = negative ? -result : result;
+      return true;
     }
-    
+
     /**
-     * @brief Displays an inverted triangle pattern
-     * @param height The number of rows in the triangle
-     * 
-     * Example (height = 3):
-     * ***
-     * **
-     * *
+     * @brief Writes a scaled value as decimal text, e.g. 12345 with 2 decimals -> "123.45"
+     * @param out Buffer with room for at least 22 characters
+     * @return Pointer one past the last character written
      */
-    void displayInvertedTriangle(int height) {
-      for (int i = 0; i < height; i++) {
-        for(int j = height; j > i; j--) {
-          cout << "*";
+    static char* format(char* out, int64_t value, int decimals) {
+      uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+      if (value < 0) *out++ = '-';
+
+      uint64_t unit = static_cast<uint64_t>(scale(decimals));
+      out = to_chars(out, out + 21, magnitude / unit).ptr;
+      if (decimals > 0) {
+        *out++ = '.';
+        uint64_t fraction = magnitude % unit;
+        for (int i = decimals - 1; i >= 0; i--) {
+          out[i] = static_cast<char>('0' + fraction % 10);
+          fraction /= 10;
         }
-        cout << "\n";
+        out += decimals;
       }
+      return out;
     }
 
-  public:
     /**
-     * @brief Runs the Triangle Loop Activity
-     * 
-     * Provides a menu for users to choose triangle type,
-     * specify height, and view the generated patterns.
+     * @brief Maps "half-up", "half-even" or "down" to a RoundingMode
+     * @return false if the name is not recognised
      */
-    void runTriangleActivity() {
-      // constant value of min and max value to required to pass
-      const int MIN_MENU_OPTION = 1;
-      const int MAX_MENU_OPTION = 4;
-      const int MIN_HEIGHT = 1;
-      const int MAX_HEIGHT = 20;
+    static bool parseRoundingMode(string_view name, RoundingMode& mode) {
+      if (name == "half-up") mode = RoundingMode::HalfUp;
+      else if (name == "half-even") mode = RoundingMode::HalfEven;
+      else if (name == "down") mode = RoundingMode::Down;
+      else return false;
+      return true;
+    }
+};
 
-      UI::header("Triangle Loop Activity");
-      int menuChoice, height;
+// ================================================== FILE INPUT CLASSES ======================================================
+/**
+ * @struct ParseError
+ * @brief Location and reason of a rejected field in a data file
+ */
+struct ParseError {
+  size_t line = 0;      // 1-based line number
+  size_t column = 0;    // 1-based byte column where the offending field starts
+  string message;       // Human-readable reason
+};
 
-      // Main activity loop
-      while (true) {
-        cout << "Triangle Options:\n"
-             << "1. Right Triangle\n"
-             << "2. Inverted Triangle\n"
-             << "3. Both\n"
-             << "4. Exit\n";
-        UI::line();
+/**
+ * @class MappedFile
+ * @brief Read-only view of a whole file without copying it into the heap
+ *
+ * Uses mmap() on POSIX systems and falls back to reading the file into
+ * a single buffer elsewhere. The view stays valid until the object dies.
+ */
+class MappedFile {
+  public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
 
-        // Get user's triangle choice
-        menuChoice = InputValidator::getValidatedChoice("Enter choice (1-4): ", MIN_MENU_OPTION, MAX_MENU_OPTION);
+    ~MappedFile() {
+#if defined(__unix__) || defined(__APPLE__)
+      if (address != nullptr) munmap(address, length);
+#endif
+    }
 
-        // Exit Triangle Activity
-        if (menuChoice == 4) {
-          UI::goodbyeMessage("Exiting Triangle Activity...\n");
-          UI::goodbyeMessage("Successfully Navigated to Main Menu\n\n");
-          break;
-        }
+    /**
+     * @brief Maps the given file
+     * @param path The file to open
+     * @return false if the file cannot be opened, mapped or read
+     *
+     * Only regular files are mapped. Pipes, FIFOs, /dev/stdin and the like
+     * report no size up front, so they are read to the end into a buffer.
+     */
+    bool open(const string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0) return false;
 
-        // Get triangle height (limited to 1-20 for display purposes)
-        height = InputValidator::getValidatedChoice("Enter height (1-20): ", MIN_HEIGHT, MAX_HEIGHT);
+      struct stat info;
+      if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+      }
 
-        cout << "\n";
-        switch (menuChoice) {
-          case 1:
-            cout << "Right Triangle:\n";
-            displayRightTriangle(height);
-            UI::pauseBuffer();
-            break;
-          case 2:
-            cout << "Inverted Triangle:\n";
-            displayInvertedTriangle(height);
-            UI::pauseBuffer();
-            break;
-          case 3:
-            cout << "Right Triangle:\n";
-            displayRightTriangle(height);
-            cout << "\nInverted Triangle:\n";
-            displayInvertedTriangle(height);
-            UI::pauseBuffer();
-            break;
-          default:
-            cout << "[ERROR] Choice must be 1-4. Try again.";
+      if (!S_ISREG(info.st_mode)) {
+        char block[1 << 16];
+        ssize_t received;
+        while ((received = ::read(fd, block, sizeof(block))) > 0 || (received < 0 && errno == EINTR)) {
+          if (received > 0) fallback.append(block, static_cast<size_t>(received));
+        }
+        ::close(fd);
+        return received == 0;
+      }
+
+      length = static_cast<size_t>(info.st_size);
+      if (length > 0) {
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+          ::close(fd);
+          return false;
         }
-        cout << "\n";
+        address = mapped;
+        madvise(address, length, MADV_SEQUENTIAL);
       }
+      ::close(fd);
+      return true;
+#else
+      ifstream file(path, ios::binary);
+      if (!file) return false;
+      fallback.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+      return true;
+#endif
+    }
+
+    // @brief Returns the file contents.
+    string_view text() const {
+#if defined(__unix__) || defined(__APPLE__)
+      return address ? string_view(static_cast<const char*>(address), length) : string_view(fallback);
+#else
+      return fallback;
+#endif
     }
+
+  private:
+#if defined(__unix__) || defined(__APPLE__)
+    void* address = nullptr;
+    size_t length = 0;
+#endif
+    string fallback;   // Contents read instead of mapped (non-regular files, or no mmap)
 };
 
-// ================================================== CURRENCY CALCULATOR ================================================
 /**
- * @class CurrencyCalculator
- * @brief Converts Philippine Pesos to multiple foreign currencies
- * 
- * This class handles currency conversion with real-time rates,
- * applies transaction fees, and displays comprehensive results.
+ * @class FieldReader
+ * @brief Tokenizes separator-delimited text in place
+ *
+ * Fields are returned as views into the original text and numbers are
+ * parsed with from_chars, so no std::string is built per field. Range
+ * checks mirror getValidatedDouble() and getValidatedChoice(); the first
+ * failure on a line is kept in error() with its line and column.
+ * A ' ' separator splits on runs of blanks and tabs, as in command scripts.
  */
-class CurrencyCalculator {
-  private:
-    // Current exchange rates (PHP to foreign currency)
-    const double USD_RATE = 58.2554;  // 1 USD = ₱58.2554
-    const double EUR_RATE = 67.6375;  // 1 EUR = ₱67.6375
-    const double JPY_RATE = 0.3818;   // 1 JPY = ₱0.3818
-    const double AUD_RATE = 38.3071;  // 1 AUD = ₱38.3071
-    const double TRANSACTION_FEE_RATE = 0.05; // 5% transaction fee
+class FieldReader {
+  public:
+    explicit FieldReader(string_view text, char separator = ',') : remaining(text), separator(separator) {}
 
     /**
-     * @brief Displays current exchange rates and transaction policies
+     * @brief Moves to the next line
+     * @return false once the text is exhausted
      */
-    void displayRates() {
-      UI::header("Today's Exchange Rates");
-      UI::line();
+    bool nextLine() {
+      if (remaining.empty()) return false;
 
-      cout << fixed << setprecision(4);
-      // Display conversion rates from PHP to foreign currencies
-      cout << "USD ($)   : 1 PHP = " << (1.0 / USD_RATE) << " USD\n";
-      cout << "EUR (€)   : 1 PHP = " << (1.0 / EUR_RATE) << " EUR\n";
-      cout << "JPY (¥)   : 1 PHP = " << (1.0 / JPY_RATE) << " JPY\n";
-      cout << "AUD (A$)  : 1 PHP = " << (1.0 / AUD_RATE) << " AUD\n";
+      size_t newline = remaining.find('\n');
+      current = remaining.substr(0, newline);
+      remaining.remove_prefix(newline == string_view::npos ? remaining.size() : newline + 1);
+      if (!current.empty() && current.back() == '\r') current.remove_suffix(1);
 
-      UI::line();
-      cout << setprecision(0) << "Transaction Fee" << ": " << (TRANSACTION_FEE_RATE * 100) << "%\n";
-      cout << "Minimum Transaction" << ": ₱100\n";
-      cout << "Maximum Transaction" << ": ₱100,000\n";
-      UI::line();
+      lineStart = current.data();
+      lineNumber++;
+      hasMoreFields = true;
+      return true;
     }
 
-    /**
-     * @brief Displays formatted conversion results
-     * @param amountInPHP Original PHP amount before fees
-     * @param fee Transaction fee deducted
-     * @param netPHP Net PHP amount after fee deduction
-     * @param usd Converted amount in US Dollars
-     * @param eur Converted amount in Euros
-     * @param jpy Converted amount in Japanese Yen
-     * @param aud Converted amount in Australian Dollars
-     */
-    void displayConversion(double amountInPHP, double fee, double netPHP, double usd, double eur, double jpy, double aud) {
-      UI::header("Conversion Result");
-      UI::line();
-      
-      // Display transaction summary
-      cout << fixed << setprecision(2);
-      cout << setw(18) << left << "Original Amount" << ": ₱" << amountInPHP << "\n";
-      cout << setw(18) << left << "Transaction Fee" << ": ₱" << fee << "\n";
-      cout << setw(18) << left << "Net Amount" << ": ₱" << netPHP << "\n";
+    // @brief Returns the current line without its line ending.
+    string_view line() const { return current; }
 
-      // Table column widths for aligned output
-      const int LABEL_WIDTH = 14;  // Currency label width
-      const int RATE_WIDTH  = 14;  // Exchange rate width
-      const int VALUE_WIDTH   = 12;  // Converted value width
+    // @brief Returns the 1-based number of the current line.
+    size_t currentLineNumber() const { return lineNumber; }
 
-      UI::line();
-      // Table header
-      cout << left << setw(LABEL_WIDTH) << "Currency" 
-           << left << setw(RATE_WIDTH) << "Rate (PHP per ₱1)" 
-           << right << setw(VALUE_WIDTH) << "Converted" << "\n";
+    // @brief Returns true if the current line holds only blanks.
+    bool isBlankLine() const { return trim(current).empty(); }
 
-      // Display each currency conversion
-      // USD
-      ostringstream usdRateStr;
-      usdRateStr << fixed << setprecision(2) << USD_RATE << " PHP";
-      cout << left << setw(LABEL_WIDTH) << "USD ($)       "
-           << left << setw(RATE_WIDTH) << usdRateStr.str() << "      "
-           << fixed << setprecision(2) << usd << " USD\n"
-      ;
-
-      // EUR
-      ostringstream eurRateStr;
-      eurRateStr << fixed << setprecision(2) << EUR_RATE << " PHP";
-      cout << left << setw(LABEL_WIDTH) << "EUR (€)       "
-           << left << setw(RATE_WIDTH) << eurRateStr.str() << "      "
-           << eur << " EUR\n"
-      ;
-
-      // JPY
-      ostringstream jpyRateStr;
-      jpyRateStr << fixed << setprecision(2) << JPY_RATE << " PHP";
-      cout << left << setw(LABEL_WIDTH) << "JPY (¥)       "
-           << left << setw(RATE_WIDTH) << jpyRateStr.str() << "      "
-           << jpy << " JPY\n"
-      ;
-
-      // AUD
-      ostringstream audRateStr;
-      audRateStr << fixed << setprecision(2) << AUD_RATE << " PHP";
-      cout << left << setw(LABEL_WIDTH) << "AUD (A$)      "
-           << left << setw(RATE_WIDTH) << audRateStr.str() << "      "
-           << aud << " AUD\n"
-      ;
-    }
+    // @brief Returns the first failure recorded on the current line.
+    const ParseError& error() const { return lastError; }
 
     /**
-     * @brief Handles the currency conversion process
-     * 
-     * Guides user through amount input, fee confirmation,
-     * calculation, and result display.
+     * @brief Reads the next field of the current line
+     * @param field Receives the trimmed field text
+     * @param label Field description used in the error message
+     * @return false if the line has no more fields
      */
-    void convertCurrency() {
-      const int MIN_AMOUNT = 100;
-      const int MAX_AMMOUNT = 100000;
-      double amountInPHP;
-
-      // Get PHP amount with validation
-      amountInPHP = InputValidator::getValidatedDouble(
-        "Enter amount in PHP (₱): ", MIN_AMOUNT, MAX_AMMOUNT
-      );
+    bool nextField(string_view& field, string_view label) {
+      const bool splitOnBlanks = separator == ' ';
+      if (splitOnBlanks) current = trim(current);
+      if (!hasMoreFields || (splitOnBlanks && current.empty())) {
+        return fail(static_cast<size_t>(current.data() - lineStart) + 1, "missing " + string(label));
+      }
 
-      // Confirm transaction with user
-      cout << "A 5% transaction fee will be charged for the exchange.\n";
-      if (!InputValidator::getValidatedYesNo("Would you like to proceed?")) {
-        UI::goodbyeMessage("Transaction cancelled.\n");
-        return;
+      size_t end = splitOnBlanks ? current.find_first_of(" \t") : current.find(separator);
+      string_view raw = current.substr(0, end);
+      if (end == string_view::npos) {
+        hasMoreFields = false;
+        current.remove_prefix(current.size());
+      } else {
+        current.remove_prefix(end + 1);
+        if (splitOnBlanks && trim(current).empty()) hasMoreFields = false;
       }
 
-      // Calculate fee and net amount
-      double fee = amountInPHP * TRANSACTION_FEE_RATE;
-      double netPHP = amountInPHP - fee;
+      field = trim(raw);
+      fieldColumn = static_cast<size_t>((field.empty() ? raw.data() : field.data()) - lineStart) + 1;
+      return true;
+    }
 
-      // Convert to all supported currencies
-      double usd = netPHP / USD_RATE;
-      double eur = netPHP / EUR_RATE;
-      double jpy = netPHP / JPY_RATE;
-      double aud = netPHP / AUD_RATE;
+    /**
+     * @brief Reads the next field as a double within [min, max]
+     * @return false if the field is missing, not a number, or out of range
+     */
+    bool nextDouble(double& value, double min, double max, string_view label) {
+      string_view field;
+      if (!nextField(field, label)) return false;
+      switch (InputValidator::parseDouble(field, min, max, value)) {
+        case InputValidator::ParseResult::NotANumber:
+          return fail(fieldColumn, string(label) + " is not a number");
+        case InputValidator::ParseResult::OutOfRange:
+          return fail(fieldColumn, string(label) + " must be between " + formatNumber(min) + " and " + formatNumber(max));
+        default:
+          return true;
+      }
+    }
 
-      // Display results
-      displayConversion(amountInPHP, fee, netPHP, usd, eur, jpy, aud);
+    /**
+     * @brief Reads the next field as a double without a range check
+     * @return false if the field is missing or not a number
+     *
+     * For batch columns whose bounds are checked afterwards by
+     * InputValidator::validateColumn().
+     */
+    bool nextNumber(double& value, string_view label) {
+      string_view field;
+      if (!nextField(field, label)) return false;
+      if (!InputValidator::parse(field, value)) return fail(fieldColumn, string(label) + " is not a number");
+      return true;
     }
 
-  public:
     /**
-     * @brief Runs the Currency Exchange Calculator activity
-     * 
-     * Provides a menu for currency exchange operations
-     * including conversion and rate viewing.
+     * @brief nextDouble() with the bounds fixed at compile time
+     * @tparam Min Smallest accepted value
+     * @tparam Max Largest accepted value
      */
-    void runCurrencyCalculator() {
-      const int MIN_MENU_OPTION = 1;
-      const int MAX_MENU_OPTION = 3;
-      int menuChoice;
+    template < auto Min, auto Max >
+    bool nextDouble(double& value, string_view label) {
+      string_view field;
+      if (!nextField(field, label)) return false;
+      switch (InputValidator::parseDouble<Min, Max>(field, value)) {
+        case InputValidator::ParseResult::NotANumber:
+          return fail(fieldColumn, string(label) + " is not a number");
+        case InputValidator::ParseResult::OutOfRange:
+          return fail(fieldColumn, string(label).append(ValueRange<Min, Max>::VALUE_BOUNDS.view()));
+        default:
+          return true;
+      }
+    }
 
-      // Main calculator loop
-      while (true) {
-        UI::header("Currency Exchange Calculator");
+    /**
+     * @brief Reads the next field as an exact fixed-point value within [min, max]
+     * @param value Receives the value scaled by 10^decimals
+     * @param decimals Digits kept after the decimal point
+     * @param mode Rounding for digits beyond decimals
+     * @param min Smallest accepted value, in whole units
+     * @param max Largest accepted value, in whole units
+     * @return false if the field is missing, not a plain decimal, or out of range
+     */
+    bool nextFixed(int64_t& value, int decimals, RoundingMode mode, int64_t min, int64_t max, string_view label) {
+      string_view field;
+      if (!nextField(field, label)) return false;
+      if (!FixedPoint::parse(field, decimals, mode, value)) return fail(fieldColumn, string(label) + " is not a decimal number");
 
-        cout << "Currency Exchange Options:\n"
-             << "1. Exchange Currency\n"
-             << "2. View Rates & Fee\n"
-             << "3. Exit\n"
-        ;
+      int64_t unit = FixedPoint::scale(decimals);
+      if (value < min * unit || value > max * unit) {
+        return fail(fieldColumn, string(label) + " must be between " + to_string(min) + " and " + to_string(max));
+      }
+      return true;
+    }
 
-        UI::line();
-        menuChoice = InputValidator::getValidatedChoice("Enter choice (1-3): ", MIN_MENU_OPTION, MAX_MENU_OPTION);
+    /**
+     * @brief Reads the next field as an integer choice within [min, max]
+     * @return false if the field is missing, not an integer, or out of range
+     */
+    bool nextInt(int& value, int min, int max, string_view label) {
+      string_view field;
+      if (!nextField(field, label)) return false;
+      switch (InputValidator::parseChoice(field, min, max, value)) {
+        case InputValidator::ParseResult::NotANumber:
+          return fail(fieldColumn, string(label) + " is not a whole number");
+        case InputValidator::ParseResult::OutOfRange:
+          return fail(fieldColumn, string(label) + " must be " + to_string(min) + "-" + to_string(max));
+        default:
+          return true;
+      }
+    }
 
-        // Exit Currency Exchange Calculator Activity
-        if (menuChoice == 3) {
-          UI::goodbyeMessage("Exiting Currency Exchange Calculator...\n");
-          UI::goodbyeMessage("Successfully Navigated to Main Menu\n\n");
+    /**
+     * @brief Records a failure against the field read last
+     * @param message Description of what is wrong with the field
+     * @return false, so callers can write "return reader.rejectField(...)"
+     */
+    bool rejectField(string message) { return fail(fieldColumn, move(message)); }
+
+    /**
+     * @brief nextInt() with the bounds fixed at compile time
+     * @tparam Min Smallest accepted value
+     * @tparam Max Largest accepted value
+     */
+    template < auto Min, auto Max >
+    bool nextInt(int& value, string_view label) {
+      string_view field;
+      if (!nextField(field, label)) return false;
+      switch (InputValidator::parseChoice<Min, Max>(field, value)) {
+        case InputValidator::ParseResult::NotANumber:
+          return fail(fieldColumn, string(label) + " is not a whole number");
+        case InputValidator::ParseResult::OutOfRange:
+          return fail(fieldColumn, string(label).append(ValueRange<Min, Max>::CHOICE_BOUNDS.view()));
+        default:
+          return true;
+      }
+    }
+
+    /**
+     * @brief Checks that the current line has no fields left
+     * @return false if there is trailing data
+     */
+    bool expectLineEnd() {
+      if (!hasMoreFields) return true;
+      return fail(static_cast<size_t>(current.data() - lineStart) + 1, "unexpected extra field");
+    }
+
+    /**
+     * @brief Checks whether a line is a column header
+     * @param line The raw line
+     * @param firstColumn Expected name of the first column (case-insensitive)
+     * @return true if the first field equals firstColumn
+     */
+    static bool isHeaderLine(string_view line, string_view firstColumn) {
+      return InputValidator::equalsIgnoreCase(trim(line.substr(0, line.find(','))), firstColumn);
+    }
+
+    // @brief Removes leading and trailing blanks without copying.
+    static string_view trim(string_view field) {
+      while (!field.empty() && (field.front() == ' ' || field.front() == '\t')) field.remove_prefix(1);
+      while (!field.empty() && (field.back() == ' ' || field.back() == '\t' || field.back() == '\r')) field.remove_suffix(1);
+      return field;
+    }
+
+  private:
+    string_view remaining;        // Text after the current line
+    string_view current;          // Unread part of the current line
+    const char* lineStart = nullptr;
+    size_t lineNumber = 0;
+    size_t fieldColumn = 0;
+    bool hasMoreFields = false;
+    char separator;
+    ParseError lastError;
+
+    // Formats a bound the way "cout << value" does
+    static string formatNumber(double value) {
+      char buffer[32];
+      return string(buffer, to_chars(buffer, buffer + sizeof(buffer), value, chars_format::general, 6).ptr);
+    }
+
+    bool fail(size_t column, string message) {
+      lastError.line = lineNumber;
+      lastError.column = column;
+      lastError.message = move(message);
+      return false;
+    }
+};
+
+// ================================================== OUTPUT WRITER CLASS ======================================================
+/**
+ * @class OutputWriter
+ * @brief Block-buffered writer for large generated output
+ *
+ * Bytes collect in one reusable buffer and leave in large blocks, either
+ * through an ostream or straight to a file descriptor. Runs of the same
+ * character are written with a memset-style fill instead of per-character
+ * stream calls.
+ */
+class OutputWriter {
+  public:
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+    // @brief Writes through an ostream (e.g. cout, so it interleaves with other console output).
+    explicit OutputWriter(ostream& stream) : stream(&stream) { adoptBuffer(); }
+
+    // @brief Writes straight to a file descriptor, bypassing iostreams.
+    explicit OutputWriter(int fd) : fd(fd) { adoptBuffer(); }
+
+    // @brief Appends to an in-memory string (e.g. a response being assembled).
+    explicit OutputWriter(string& target) : target(&target) {}
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    ~OutputWriter() {
+      flush();
+      recycleBuffer();
+    }
+
+    // @brief Appends count copies of c.
+    void fill(char c, size_t count) {
+      while (count > 0) {
+        size_t room = BUFFER_SIZE - buffer.size();
+        if (room == 0) {
+          flush();
+          continue;
+        }
+        size_t chunk = min(room, count);
+        buffer.append(chunk, c);
+        count -= chunk;
+      }
+    }
+
+    // @brief Appends length bytes from data.
+    void write(const char* data, size_t length) {
+      if (buffer.size() + length > BUFFER_SIZE) {
+        flush();
+        if (length >= BUFFER_SIZE) {
+          emit(data, length);
+          return;
+        }
+      }
+      buffer.append(data, length);
+    }
+
+    void write(string_view text) { write(text.data(), text.size()); }
+
+    /**
+     * @brief Writes several caller-owned slices in order without copying them
+     * @param slices Views that only need to stay valid for the duration of the call
+     * @param count Number of slices
+     *
+     * On a file descriptor this is one writev() per IOV_MAX slices;
+     * buffered bytes are flushed first so ordering is preserved.
+     */
+    void writeSlices(const string_view* slices, size_t count) {
+      flush();
+#if defined(__unix__) || defined(__APPLE__)
+      if (stream == nullptr && target == nullptr) {
+        iovec vectors[IOV_MAX];
+        while (count > 0 && !failed) {
+          int batch = static_cast<int>(min<size_t>(count, IOV_MAX));
+          for (int i = 0; i < batch; i++) {
+            vectors[i].iov_base = const_cast<char*>(slices[i].data());
+            vectors[i].iov_len = slices[i].size();
+          }
+          emitVector(vectors, batch);
+          slices += batch;
+          count -= static_cast<size_t>(batch);
+        }
+        return;
+      }
+#endif
+      for (size_t i = 0; i < count; i++) emit(slices[i].data(), slices[i].size());
+    }
+
+    void put(char c) {
+      if (buffer.size() == BUFFER_SIZE) flush();
+      buffer += c;
+    }
+
+    // @brief Sends everything buffered so far.
+    void flush() {
+      if (buffer.empty()) return;
+      emit(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+
+    // @brief Returns false once a write to the target has failed.
+    bool good() const { return !failed; }
+
+  private:
+    ostream* stream = nullptr;
+    string* target = nullptr;
+    int fd = -1;
+    string buffer;
+    bool failed = false;
+
+    // One spare buffer per thread, so short-lived writers (one per menu display) don't reallocate
+    static string& spareBuffer() {
+      thread_local string spare;
+      return spare;
+    }
+
+    void adoptBuffer() {
+      buffer.swap(spareBuffer());
+      buffer.reserve(BUFFER_SIZE);
+    }
+
+    void recycleBuffer() {
+      buffer.clear();
+      if (buffer.capacity() > spareBuffer().capacity()) buffer.swap(spareBuffer());
+    }
+
+    void emit(const char* data, size_t length) {
+      if (target != nullptr) {
+        target->append(data, length);
+        return;
+      }
+      if (stream != nullptr) {
+        stream->write(data, static_cast<streamsize>(length));
+        failed |= !*stream;
+        return;
+      }
+#if defined(__unix__) || defined(__APPLE__)
+      while (length > 0 && !failed) {
+        ssize_t written = ::write(fd, data, length);
+        if (written < 0) {
+          failed = errno != EINTR;
+          continue;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+      }
+#else
+      failed = true;
+#endif
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // writev() that finishes partial writes by advancing through the vector
+    void emitVector(iovec* vectors, int count) {
+      while (count > 0 && !failed) {
+        ssize_t written = ::writev(fd, vectors, count);
+        if (written < 0) {
+          failed = errno != EINTR;
+          continue;
+        }
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= vectors->iov_len) {
+          remaining -= vectors->iov_len;
+          vectors++;
+          count--;
+        }
+        if (count > 0) {
+          vectors->iov_base = static_cast<char*>(vectors->iov_base) + remaining;
+          vectors->iov_len -= remaining;
+        }
+      }
+    }
+#endif
+};
+
+// ================================================== COLUMNAR FORMAT CLASS ======================================================
+// @brief How the batch modes encode their results.
+enum class ResultFormat { Text, Columnar };
+
+/**
+ * @struct ColumnarFormat
+ * @brief Binary, column-oriented result files that can be read in place
+ *
+ * Layout, in native byte order (FileHeader::byteOrder tells readers which):
+ *   FileHeader
+ *   ColumnDescriptor x columnCount      the schema
+ *   record batch...                     until end of file
+ * and each record batch is
+ *   BatchHeader                         rowCount, then the size of the body
+ *   one buffer per column, in schema order, each padded to 8 bytes
+ *
+ * Float64, Int64 and UInt8 columns are rowCount plain values. Utf8
+ * columns are rowCount + 1 uint32 offsets (starting at 0), padded, then
+ * the bytes they index. Every structure and buffer starts 8-byte aligned
+ * relative to the file start, so an mmap'ed file is read by pointer
+ * arithmetic alone. Writers copy their structure-of-arrays buffers
+ * straight into a batch.
+ */
+struct ColumnarFormat {
+  static constexpr char MAGIC[8] = {'R', 'E', 'S', 'U', 'L', 'T', 'S', '\0'};
+  static constexpr uint32_t VERSION = 1;
+
+  enum class ColumnType : uint32_t { Float64 = 1, Int64 = 2, UInt8 = 3, Utf8 = 4 };
+
+  struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;     // 0x01020304 as written by the producer
+    uint32_t columnCount;
+    uint32_t reserved;
+  };
+
+  struct ColumnDescriptor {
+    char name[24];          // NUL-padded
+    ColumnType type;
+    int32_t scale;          // Int64 only: the value is scaled by 10^scale (e.g. 2 for centavos)
+  };
+
+  struct BatchHeader {
+    uint64_t rowCount;
+    uint64_t bodyBytes;     // Bytes of column buffers after this header
+  };
+
+  static_assert(sizeof(FileHeader) % 8 == 0 && sizeof(ColumnDescriptor) % 8 == 0 && sizeof(BatchHeader) % 8 == 0,
+                "columnar structures keep 8-byte alignment");
+
+  // @brief Makes a schema entry; the name is cut to 23 bytes.
+  static ColumnDescriptor column(string_view name, ColumnType type, int32_t scale = 0) {
+    ColumnDescriptor descriptor = {};
+    memcpy(descriptor.name, name.data(), min(name.size(), sizeof(descriptor.name) - 1));
+    descriptor.type = type;
+    descriptor.scale = scale;
+    return descriptor;
+  }
+
+  // @brief Appends the file header and schema.
+  static void appendSchema(string& out, span<const ColumnDescriptor> columns) {
+    FileHeader header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = 0x01020304;
+    header.columnCount = static_cast<uint32_t>(columns.size());
+    appendBuffer(out, &header, sizeof(header));
+    appendBuffer(out, columns.data(), columns.size_bytes());
+  }
+
+  // @brief Starts a record batch; returns the position endBatch() needs.
+  static size_t beginBatch(string& out, uint64_t rowCount) {
+    size_t position = out.size();
+    BatchHeader header = {rowCount, 0};
+    appendBuffer(out, &header, sizeof(header));
+    return position;
+  }
+
+  // @brief Appends one column buffer, padded with zeros to 8 bytes.
+  static void appendBuffer(string& out, const void* data, size_t bytes) {
+    out.append(static_cast<const char*>(data), bytes);
+    out.append((8 - bytes % 8) % 8, '\0');
+  }
+
+  // @brief Records the body size of the batch begun at position.
+  static void endBatch(string& out, size_t position) {
+    uint64_t bodyBytes = out.size() - position - sizeof(BatchHeader);
+    memcpy(&out[position + offsetof(BatchHeader, bodyBytes)], &bodyBytes, sizeof(bodyBytes));
+  }
+};
+
+// ================================================== WORK STEALING POOL CLASS ===================================================
+/**
+ * @class WorkStealingPool
+ * @brief Fixed-size thread pool where idle workers steal queued tasks
+ *
+ * Every worker owns a deque. Tasks submitted from outside the pool are
+ * spread round-robin; tasks submitted from inside a worker go to that
+ * worker's own deque. A worker pops its newest task first and, when its
+ * deque is empty, steals the oldest task from another worker.
+ */
+class WorkStealingPool {
+  public:
+    static constexpr unsigned MAX_WORKERS = 1024;   // Largest pool --threads may ask for, on any machine
+
+    /**
+     * @brief Starts the worker threads
+     * @param threadCount Number of workers (0 is treated as 1)
+     */
+    explicit WorkStealingPool(unsigned threadCount) {
+      if (threadCount == 0) threadCount = 1;
+      for (unsigned i = 0; i < threadCount; i++) workers.push_back(make_unique<Worker>());
+      for (unsigned i = 0; i < threadCount; i++) threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+
+    ~WorkStealingPool() { shutdown(); }
+
+    /**
+     * @brief Finishes every queued task, then joins the workers
+     *
+     * Lets an owner drain the pool before tearing down what its tasks
+     * use. Call it from outside the pool; later calls do nothing.
+     */
+    void shutdown() {
+      {
+        lock_guard<mutex> guard(sleepLock);
+        stopping = true;
+      }
+      wakeUp.notify_all();
+      for (thread& worker : threads) worker.join();
+      threads.clear();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // @brief Returns the number of worker threads.
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    /**
+     * @brief Queues a task for execution on one of the workers
+     * @param task The callable to run; it must not throw
+     */
+    void submit(function<void()> task) {
+      size_t target = (currentPool == this) ? currentIndex : nextWorker.fetch_add(1) % workers.size();
+      {
+        lock_guard<mutex> guard(workers[target]->lock);
+        workers[target]->tasks.push_back(move(task));
+      }
+      {
+        lock_guard<mutex> guard(sleepLock);
+        queued++;
+      }
+      wakeUp.notify_one();
+    }
+
+  private:
+    struct Worker {
+      mutex lock;
+      deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<Worker>> workers;
+    vector<thread> threads;
+    atomic<size_t> nextWorker{0};
+
+    mutex sleepLock;              // Guards queued and stopping
+    condition_variable wakeUp;
+    long long queued = 0;         // Tasks pushed but not yet taken (may dip below 0 briefly)
+    bool stopping = false;
+
+    static inline thread_local const WorkStealingPool* currentPool = nullptr;
+    static inline thread_local size_t currentIndex = 0;
+
+    // Takes the newest task from the worker's own deque, or the oldest from a victim's
+    bool takeTask(size_t index, function<void()>& task) {
+      {
+        Worker& own = *workers[index];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+          task = move(own.tasks.back());
+          own.tasks.pop_back();
+          return true;
+        }
+      }
+      for (size_t offset = 1; offset < workers.size(); offset++) {
+        Worker& victim = *workers[(index + offset) % workers.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+          task = move(victim.tasks.front());
+          victim.tasks.pop_front();
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void workerLoop(size_t index) {
+      currentPool = this;
+      currentIndex = index;
+
+      while (true) {
+        function<void()> task;
+        if (takeTask(index, task)) {
+          {
+            lock_guard<mutex> guard(sleepLock);
+            queued--;
+          }
+          task();
+          continue;
+        }
+
+        unique_lock<mutex> guard(sleepLock);
+        wakeUp.wait(guard, [this]() { return stopping || queued > 0; });
+        if (stopping && queued <= 0) return;
+      }
+    }
+};
+
+// ================================================== VIRTUAL STUDENT INFO CLASS =================================================
+/**
+ * @class VirtualStudentInfo
+ * @brief Displays static student information
+ * 
+ * This class provides a simple interface to show predefined
+ * student details when selected from the main menu.
+ */
+class VirtualStudentInfo {
+  private:
+    // Static student information, shared by the menu and scripts
+    static constexpr string_view STUDENT_DETAILS =
+      "Name: Alberto Jr Deniros\n"
+      "Section and Course: BSCS 1-A\n"
+      "AGE: 23\n"
+      "GENDER: MALE\n"
+      "CODING DEVICES: Desktop Computer\n"
+    ;
+
+  public:
+    /**
+     * @brief Runs the Virtual Student Info activity
+     * 
+     * Displays a formatted header followed by the student's
+     * personal and academic information.
+     */
+    Task<> runStudentInfo(Session& session) const {
+      UI::header(session.out, "Virtual Student Info");
+
+      // Display static student information
+      session.out << STUDENT_DETAILS;
+      
+      co_await UI::pauseBuffer(session);
+    }
+
+    // @brief Writes the student information without the header or pause.
+    static void writeStudentInfo(OutputWriter& out) {
+      out.write(STUDENT_DETAILS);
+    }
+};
+
+// ================================================== STUDENT GRADE EVALUATOR CLASS =================================================
+/**
+ * @class StudentGradeEvaluator
+ * @brief Evaluates student grades and determines pass/fail status
+ * 
+ * This class collects four grades from the user, calculates the average,
+ * and compares it against a passing threshold to determine the result.
+ * The periods, their weights, the threshold and optional letter bands
+ * come from a GradingPolicy.
+ */
+class StudentGradeEvaluator {
+  public:
+    static constexpr int NUMBER_OF_GRADES = 4;      // Total number of grades to collect
+    static constexpr int PASSING_GRADE = 80;        // Minimum average required to pass
+    static constexpr int MIN_GRADE = 0;             // Min Grade required
+    static constexpr int MAX_GRADE = 100;           // Max Grade required
+
+    /**
+     * @class GradingPolicy
+     * @brief Weighted grading periods, passing grade and letter bands
+     *
+     * A policy file is compiled once into a flat vector of normalized
+     * weights and a band table indexed by hundredths of a point, so
+     * grading a student is one multiply-add per period plus one table
+     * load, with no rules interpreted per row.
+     *
+     * The standard policy is the activity's four equally weighted periods
+     * with PASSING_GRADE and no bands. Its weights are 1/4, and products
+     * with 1/4 are exact, so its averages are bit-identical to summing the
+     * periods and dividing by NUMBER_OF_GRADES.
+     */
+    class GradingPolicy {
+      public:
+        static constexpr size_t MAX_COMPONENTS = 8;       // Graded periods a policy may define
+        static constexpr size_t MAX_BANDS = 16;           // Letter bands a policy may define
+        static constexpr size_t MAX_NAME_BYTES = 16;      // Longest period name
+        static constexpr size_t MAX_LETTER_BYTES = 4;     // Longest band letter (e.g. "A+")
+
+        // @brief Returns the built-in four-period, equal-weight policy.
+        static const GradingPolicy& standard() {
+          static const GradingPolicy policy = []() {
+            GradingPolicy standard;
+            for (string_view name : {"Prelim", "Midterm", "PreFinal", "Final"}) standard.addComponent(name, 1);
+            standard.passing = PASSING_GRADE;
+            standard.compile();
+            return standard;
+          }();
+          return policy;
+        }
+
+        /**
+         * @brief Replaces the policy with the rules of a policy file
+         * @param text File contents, one rule per line:
+         *   component,<name>,<weight>    one graded period, in roster column order
+         *   passing,<grade>              minimum weighted average that passes (default PASSING_GRADE)
+         *   band,<letter>,<minimum>      letter for averages from minimum up to the next band
+         * @param errors Receives the line, column and reason of each rejected line
+         * @return true if the file defines at least one component and nothing was rejected
+         *
+         * Weights are relative and normalized to sum to 1. Band minimums
+         * are read to two decimals (further digits round half-even), and
+         * when bands are given the lowest must start at MIN_GRADE. Blank lines and "#" comments are
+         * skipped. On failure the current policy is left unchanged.
+         */
+        bool load(string_view text, vector<ParseError>& errors) {
+          GradingPolicy loaded;
+          loaded.passing = PASSING_GRADE;
+          size_t errorCount = errors.size();
+
+          FieldReader reader(text);
+          while (reader.nextLine()) {
+            string_view line = FieldReader::trim(reader.line());
+            if (line.empty() || line.front() == '#') continue;
+
+            string_view rule, name;
+            bool valid = reader.nextField(rule, "rule");
+            if (valid && rule == "component") {
+              double weight;
+              valid = reader.nextField(name, "period name")
+                   && reader.nextDouble(weight, 0, MAX_WEIGHT, "weight")
+                   && reader.expectLineEnd();
+              if (valid && (name.empty() || name.size() > MAX_NAME_BYTES)) valid = reader.rejectField("period name must be 1-" + to_string(MAX_NAME_BYTES) + " bytes");
+              if (valid && weight == 0) valid = reader.rejectField("weight must be greater than 0");
+              if (valid && loaded.count == MAX_COMPONENTS) valid = reader.rejectField("at most " + to_string(MAX_COMPONENTS) + " components");
+              if (valid) loaded.addComponent(name, weight);
+            } else if (valid && rule == "passing") {
+              valid = reader.nextDouble<MIN_GRADE, MAX_GRADE>(loaded.passing, "passing grade") && reader.expectLineEnd();
+            } else if (valid && rule == "band") {
+              int64_t minimum;
+              valid = reader.nextField(name, "band letter")
+                   && reader.nextFixed(minimum, BAND_DECIMALS, RoundingMode::HalfEven, MIN_GRADE, MAX_GRADE, "band minimum")
+                   && reader.expectLineEnd();
+              if (valid && (name.empty() || name.size() > MAX_LETTER_BYTES)) valid = reader.rejectField("band letter must be 1-" + to_string(MAX_LETTER_BYTES) + " bytes");
+              if (valid && loaded.bandCount == MAX_BANDS) valid = reader.rejectField("at most " + to_string(MAX_BANDS) + " bands");
+              for (size_t b = 0; valid && b < loaded.bandCount; b++) {
+                if (loaded.bandHundredths[b] == minimum) valid = reader.rejectField("another band starts at the same minimum");
+              }
+              if (valid) loaded.addBand(name, minimum);
+            } else if (valid) {
+              valid = reader.rejectField("rule must be component, passing or band");
+            }
+            if (!valid) errors.push_back(reader.error());
+          }
+
+          if (errors.size() != errorCount) return false;
+          if (loaded.count == 0) {
+            errors.push_back({reader.currentLineNumber(), 1, "a policy needs at least one component"});
+            return false;
+          }
+          if (loaded.bandCount > 0 && *min_element(loaded.bandHundredths, loaded.bandHundredths + loaded.bandCount) != MIN_GRADE * 100) {
+            errors.push_back({reader.currentLineNumber(), 1, "the lowest band must start at " + to_string(MIN_GRADE)});
+            return false;
+          }
+          loaded.compile();
+          *this = move(loaded);
+          return true;
+        }
+
+        // @brief Returns the number of graded periods.
+        size_t components() const { return count; }
+
+        // @brief Returns the normalized weight of every period, in column order.
+        const double* weights() const { return weight; }
+
+        // @brief Returns a period's name (e.g. "Prelim").
+        string_view name(size_t component) const { return names[component]; }
+
+        // @brief Returns a period's field label for error messages (e.g. "Prelim grade").
+        string_view label(size_t component) const { return labels[component]; }
+
+        double passingGrade() const { return passing; }
+
+        bool hasBands() const { return bandCount > 0; }
+
+        // @brief Returns the letter of a band index from bandOf().
+        string_view letter(size_t band) const { return letters[band]; }
+
+        // @brief The weighted average of one student's periods, as the batch kernel computes it.
+        double average(const double* values) const {
+          double total = values[0] * weight[0];
+          for (size_t i = 1; i < count; i++) total = multiplyAdd(values[i], weight[i], total);
+          return total;
+        }
+
+        /**
+         * @brief Returns the band index of an average (hasBands() must be true)
+         *
+         * The table gives the band of the average's hundredth; one compare
+         * against the neighbouring minimum fixes the rare average whose
+         * hundredth rounded across a band edge.
+         */
+        size_t bandOf(double average) const {
+          const double scaled = (average - MIN_GRADE) * 100;
+          const size_t slot = scaled > 0 ? min(BAND_TABLE_SIZE - 1, static_cast<size_t>(scaled)) : 0;
+          size_t band = bandTable[slot];
+          if (band + 1 < bandCount && average >= bandMinimum[band + 1]) band++;
+          else if (band > 0 && average < bandMinimum[band]) band--;
+          return band;
+        }
+
+        // @brief a * b + c, fused when the target has FMA; every grading kernel rounds through this.
+        static double multiplyAdd(double a, double b, double c) {
+#if defined(__FMA__) || defined(__ARM_FEATURE_FMA)
+          return fma(a, b, c);
+#else
+          return a * b + c;
+#endif
+        }
+
+      private:
+        static constexpr double MAX_WEIGHT = 1000;        // Largest relative weight accepted
+        static constexpr int BAND_DECIMALS = 2;           // Band minimums are whole hundredths
+        static constexpr size_t BAND_TABLE_SIZE = (MAX_GRADE - MIN_GRADE) * 100 + 1;
+
+        size_t count = 0;
+        double rawWeight[MAX_COMPONENTS] = {};            // As written in the policy file
+        double weight[MAX_COMPONENTS] = {};               // rawWeight normalized to sum to 1
+        string names[MAX_COMPONENTS];
+        string labels[MAX_COMPONENTS];
+        double passing = PASSING_GRADE;
+
+        size_t bandCount = 0;                             // Bands, sorted by minimum once compiled
+        int64_t bandHundredths[MAX_BANDS] = {};
+        double bandMinimum[MAX_BANDS] = {};
+        string letters[MAX_BANDS];
+        vector<uint8_t> bandTable;                        // Band index per hundredth of a point, empty without bands
+
+        void addComponent(string_view name, double relativeWeight) {
+          names[count].assign(name);
+          labels[count].assign(name).append(" grade");
+          rawWeight[count++] = relativeWeight;
+        }
+
+        void addBand(string_view letter, int64_t minimumHundredths) {
+          letters[bandCount].assign(letter);
+          bandHundredths[bandCount++] = minimumHundredths;
+        }
+
+        // Normalizes the weights, sorts the bands and fills the band table
+        void compile() {
+          double total = 0;
+          for (size_t i = 0; i < count; i++) total += rawWeight[i];
+          for (size_t i = 0; i < count; i++) weight[i] = rawWeight[i] / total;
+
+          for (size_t i = 1; i < bandCount; i++) {
+            for (size_t j = i; j > 0 && bandHundredths[j - 1] > bandHundredths[j]; j--) {
+              swap(bandHundredths[j - 1], bandHundredths[j]);
+              swap(letters[j - 1], letters[j]);
+            }
+          }
+          for (size_t b = 0; b < bandCount; b++) bandMinimum[b] = static_cast<double>(bandHundredths[b]) / 100;
+
+          bandTable.clear();
+          if (bandCount == 0) return;
+          bandTable.resize(BAND_TABLE_SIZE);
+          size_t band = 0;
+          for (size_t slot = 0; slot < BAND_TABLE_SIZE; slot++) {
+            while (band + 1 < bandCount && static_cast<int64_t>(slot) + MIN_GRADE * 100 >= bandHundredths[band + 1]) band++;
+            bandTable[slot] = static_cast<uint8_t>(band);
+          }
+        }
+    };
+
+    /**
+     * @struct RunningMoments
+     * @brief Count, mean and squared deviations of a value stream, updated in one pass
+     *
+     * add() is Welford's update. merge() combines two partial results as
+     * if every value had gone into one accumulator (Chan et al.), so the
+     * chunks of the parallel evaluator fold into the same totals.
+     * replace() swaps one value already added for another in O(1).
+     */
+    struct RunningMoments {
+      size_t count = 0;
+      double mean = 0;
+      double m2 = 0;   // Sum of squared deviations from the mean
+
+      void add(double value) {
+        count++;
+        double delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (value - mean);
+      }
+
+      // Count is unchanged, so both sums move by (newValue - oldValue): m2 by it times (newValue + oldValue - both means)
+      void replace(double oldValue, double newValue) {
+        if (count == 0) return;
+        const double change = newValue - oldValue;
+        const double oldMean = mean;
+        mean += change / static_cast<double>(count);
+        m2 = max(0.0, m2 + change * (newValue - mean + oldValue - oldMean));
+      }
+
+      // Adds a whole column: one pass for its mean, one for its deviations, then a merge
+      void addBlock(const double* values, size_t n) {
+        if (n == 0) return;
+        RunningMoments block;
+        block.count = n;
+        double sum = 0;
+        for (size_t i = 0; i < n; i++) sum += values[i];
+        block.mean = sum / static_cast<double>(n);
+        for (size_t i = 0; i < n; i++) block.m2 += (values[i] - block.mean) * (values[i] - block.mean);
+        merge(block);
+      }
+
+      void merge(const RunningMoments& other) {
+        if (other.count == 0) return;
+        if (count == 0) {
+          *this = other;
+          return;
+        }
+        const double total = static_cast<double>(count + other.count);
+        const double delta = other.mean - mean;
+        mean += delta * static_cast<double>(other.count) / total;
+        m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+        count += other.count;
+      }
+
+      // @brief Population variance (the cohort is the whole population).
+      double variance() const { return count > 0 ? m2 / static_cast<double>(count) : 0; }
+      double standardDeviation() const { return sqrt(variance()); }
+    };
+
+    /**
+     * @struct CohortStatistics
+     * @brief Streaming analytics of the evaluated students of a roster
+     *
+     * Holds per-period and average moments plus a histogram of averages
+     * in 0.1-point buckets over MIN_GRADE..MAX_GRADE. Its size does not
+     * depend on the number of students, and percentiles come from the
+     * histogram, so a roster never has to be kept or sorted.
+     */
+    struct CohortStatistics {
+      static constexpr size_t BUCKETS_PER_POINT = 10;
+      static constexpr size_t BUCKET_COUNT = (MAX_GRADE - MIN_GRADE) * BUCKETS_PER_POINT + 1;   // The last holds MAX_GRADE itself
+
+      RunningMoments period[GradingPolicy::MAX_COMPONENTS];   // The policy's periods, in column order
+      RunningMoments average;
+      vector<uint64_t> histogram;   // Students per bucket of their average; allocated on first use
+
+      void addAverage(double value) {
+        if (histogram.empty()) histogram.resize(BUCKET_COUNT);
+        histogram[bucketOf(value)]++;
+      }
+
+      // Swaps one student's average in both the moments and the histogram; oldValue must have been added to each
+      void replaceAverage(double oldValue, double newValue) {
+        average.replace(oldValue, newValue);
+        histogram[bucketOf(oldValue)]--;
+        histogram[bucketOf(newValue)]++;
+      }
+
+      void merge(const CohortStatistics& other) {
+        for (size_t i = 0; i < GradingPolicy::MAX_COMPONENTS; i++) period[i].merge(other.period[i]);
+        average.merge(other.average);
+        if (other.histogram.empty()) return;
+        if (histogram.empty()) histogram.resize(BUCKET_COUNT);
+        for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) histogram[bucket] += other.histogram[bucket];
+      }
+
+      /**
+       * @brief Approximate p-th percentile of the averages (0 if there are none)
+       *
+       * Interpolates linearly inside the bucket holding the rank, so the
+       * error is below one bucket width (0.1 points).
+       */
+      double percentile(double p) const {
+        if (average.count == 0) return 0;
+        const double rank = p / 100.0 * static_cast<double>(average.count);
+        double seen = 0;
+        for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+          const double inBucket = static_cast<double>(histogram[bucket]);
+          if (inBucket > 0 && seen + inBucket >= rank) {
+            const double width = bucket + 1 < BUCKET_COUNT ? 1.0 / BUCKETS_PER_POINT : 0.0;
+            return MIN_GRADE + static_cast<double>(bucket) / BUCKETS_PER_POINT + width * max(0.0, rank - seen) / inBucket;
+          }
+          seen += inBucket;
+        }
+        return MAX_GRADE;
+      }
+
+      // @brief Returns the number of averages in [from, to), or [from, MAX_GRADE] when to is MAX_GRADE.
+      uint64_t countBetween(int from, int to) const {
+        if (histogram.empty()) return 0;
+        size_t first = static_cast<size_t>(from - MIN_GRADE) * BUCKETS_PER_POINT;
+        size_t last = to >= MAX_GRADE ? BUCKET_COUNT : static_cast<size_t>(to - MIN_GRADE) * BUCKETS_PER_POINT;
+        uint64_t total = 0;
+        for (size_t bucket = first; bucket < last; bucket++) total += histogram[bucket];
+        return total;
+      }
+
+      static size_t bucketOf(double value) {
+        double scaled = (value - MIN_GRADE) * BUCKETS_PER_POINT;
+        return scaled > 0 ? min(BUCKET_COUNT - 1, static_cast<size_t>(scaled)) : 0;
+      }
+    };
+
+    /**
+     * @struct RosterSummary
+     * @brief Totals reported at the end of a batch roster run
+     */
+    struct RosterSummary {
+      size_t evaluated = 0;          // Students graded successfully
+      size_t passed = 0;             // Students whose average reached the passing grade
+      size_t rejected = 0;           // Lines skipped because of malformed or out-of-range data
+      CohortStatistics statistics;   // Moments and histogram of the evaluated students
+
+      void merge(const RosterSummary& other) {
+        evaluated += other.evaluated;
+        passed += other.passed;
+        rejected += other.rejected;
+        statistics.merge(other.statistics);
+      }
+    };
+
+    /**
+     * @struct GradeColumns
+     * @brief Structure-of-arrays store for a batch of students
+     *
+     * Each grading period is one contiguous column of doubles, so the
+     * averaging kernel streams through memory instead of hopping between
+     * Grade objects. Student IDs are packed into a single byte buffer.
+     */
+    struct GradeColumns {
+      size_t components = NUMBER_OF_GRADES;     // Period columns in use (the policy's component count)
+      string idBytes;                           // All student IDs back to back
+      vector<uint32_t> idOffsets = {0};         // Row r's ID is idBytes[idOffsets[r], idOffsets[r + 1])
+      vector<double> period[GradingPolicy::MAX_COMPONENTS];   // One column per grading period, in roster order
+      vector<double> average;                   // Filled by evaluateColumns()
+      vector<uint8_t> passed;                   // 1 if average reached the passing grade, filled by evaluateColumns()
+      vector<uint8_t> band;                     // Letter band index, filled by evaluateColumns() if the policy has bands
+
+      size_t size() const { return idOffsets.size() - 1; }
+
+      string_view id(size_t row) const {
+        return string_view(idBytes).substr(idOffsets[row], idOffsets[row + 1] - idOffsets[row]);
+      }
+
+      void append(string_view studentId, const double values[]) {
+        idBytes.append(studentId.data(), studentId.size());
+        idOffsets.push_back(static_cast<uint32_t>(idBytes.size()));
+        for (size_t i = 0; i < components; i++) period[i].push_back(values[i]);
+      }
+
+      /**
+       * @brief Drops the rows whose bit in keep is clear, preserving order
+       * @param keep One bit per row, as filled by InputValidator::validateColumn()
+       *
+       * Requires evaluateColumns() to have run, since average, passed and band move too.
+       */
+      void keepRows(const uint64_t* keep) {
+        const size_t rows = size();
+        size_t kept = 0;
+        uint32_t bytes = 0;
+        uint32_t start = 0;   // Original start of the current row's ID, before idOffsets is overwritten
+        for (size_t row = 0; row < rows; row++) {
+          const uint32_t end = idOffsets[row + 1];
+          if ((keep[row / 64] >> (row % 64)) & 1) {
+            memmove(&idBytes[bytes], &idBytes[start], end - start);
+            bytes += end - start;
+            for (size_t i = 0; i < components; i++) period[i][kept] = period[i][row];
+            average[kept] = average[row];
+            passed[kept] = passed[row];
+            if (!band.empty()) band[kept] = band[row];
+            idOffsets[++kept] = bytes;
+          }
+          start = end;
+        }
+
+        idBytes.resize(bytes);
+        idOffsets.resize(kept + 1);
+        for (size_t i = 0; i < components; i++) period[i].resize(kept);
+        average.resize(kept);
+        passed.resize(kept);
+        if (!band.empty()) band.resize(kept);
+      }
+
+      // Appends rows [first, last) of an evaluated block: IDs, periods, average, passed and band
+      void appendRows(const GradeColumns& source, size_t first, size_t last) {
+        const uint32_t start = source.idOffsets[first];
+        const uint32_t base = static_cast<uint32_t>(idBytes.size());
+        idBytes.append(source.idBytes, start, source.idOffsets[last] - start);
+        for (size_t row = first; row < last; row++) idOffsets.push_back(base + source.idOffsets[row + 1] - start);
+        for (size_t i = 0; i < components; i++) period[i].insert(period[i].end(), source.period[i].begin() + first, source.period[i].begin() + last);
+        average.insert(average.end(), source.average.begin() + first, source.average.begin() + last);
+        passed.insert(passed.end(), source.passed.begin() + first, source.passed.begin() + last);
+        if (!source.band.empty()) band.insert(band.end(), source.band.begin() + first, source.band.begin() + last);
+      }
+
+      // Keeps the allocated capacity so the next block reuses it
+      void clear() {
+        idBytes.clear();
+        idOffsets.resize(1);
+        for (size_t i = 0; i < components; i++) period[i].clear();
+        average.clear();
+        passed.clear();
+        band.clear();
+      }
+    };
+
+    /**
+     * @brief Computes the average and pass/fail flag of every row in one pass
+     * @param columns The batch to evaluate; average and passed are resized to fit
+     * @param policy Weights, passing grade and bands; columns.components must match it
+     *
+     * Uses AVX2 (4 rows per step) or NEON (2 rows per step) when the build
+     * targets them, with a scalar loop for the remainder and other targets.
+     * Each average is the first period times its weight, then one
+     * multiply-add per further period in roster order, rounded exactly
+     * like GradingPolicy::average(), so every lane matches the interactive
+     * result bit for bit. Bands are looked up afterwards, one load per row.
+     */
+    static void evaluateColumns(GradeColumns& columns, const GradingPolicy& policy = GradingPolicy::standard()) {
+      const size_t rows = columns.size();
+      columns.average.resize(rows);
+      columns.passed.resize(rows);
+
+      // One instantiation per period count, so the period loop is unrolled as it was for the fixed four
+      static constexpr auto KERNELS = []<size_t... Index>(index_sequence<Index...>) {
+        return array<void (*)(GradeColumns&, const GradingPolicy&), sizeof...(Index)>{&weightedAverages<Index + 1>...};
+      }(make_index_sequence<GradingPolicy::MAX_COMPONENTS>());
+      KERNELS[policy.components() - 1](columns, policy);
+
+      if (!policy.hasBands()) return;
+      const double* average = columns.average.data();
+      columns.band.resize(rows);
+      for (size_t row = 0; row < rows; row++) columns.band[row] = static_cast<uint8_t>(policy.bandOf(average[row]));
+    }
+
+  private:
+    // evaluateColumns() with the number of periods fixed at compile time
+    template < size_t Components >
+    static void weightedAverages(GradeColumns& columns, const GradingPolicy& policy) {
+      const size_t rows = columns.size();
+      const double* period[Components];
+      for (size_t i = 0; i < Components; i++) period[i] = columns.period[i].data();
+      const double* weight = policy.weights();
+      double* average = columns.average.data();
+      uint8_t* passed = columns.passed.data();
+
+      size_t row = 0;
+#if defined(__AVX2__)
+      __m256d weights[Components];
+      for (size_t i = 0; i < Components; i++) weights[i] = _mm256_set1_pd(weight[i]);
+      const __m256d passing = _mm256_set1_pd(policy.passingGrade());
+      for (; row + 4 <= rows; row += 4) {
+        __m256d avg = _mm256_mul_pd(_mm256_loadu_pd(period[0] + row), weights[0]);
+#pragma GCC unroll 8   // -O2 keeps even this short loop rolled, reloading weights and columns every step
+        for (size_t i = 1; i < Components; i++) {
+#if defined(__FMA__)
+          avg = _mm256_fmadd_pd(_mm256_loadu_pd(period[i] + row), weights[i], avg);
+#else
+          avg = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(period[i] + row), weights[i]), avg);
+#endif
+        }
+        _mm256_storeu_pd(average + row, avg);
+
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(avg, passing, _CMP_GE_OQ));
+        passed[row]     = mask & 1;
+        passed[row + 1] = (mask >> 1) & 1;
+        passed[row + 2] = (mask >> 2) & 1;
+        passed[row + 3] = (mask >> 3) & 1;
+      }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+      const float64x2_t passing = vdupq_n_f64(policy.passingGrade());
+      for (; row + 2 <= rows; row += 2) {
+        float64x2_t avg = vmulq_n_f64(vld1q_f64(period[0] + row), weight[0]);
+        // AArch64 always has FMA, which multiplyAdd() uses as well
+#pragma GCC unroll 8
+        for (size_t i = 1; i < Components; i++) avg = vfmaq_n_f64(avg, vld1q_f64(period[i] + row), weight[i]);
+        vst1q_f64(average + row, avg);
+
+        uint64x2_t mask = vcgeq_f64(avg, passing);
+        passed[row]     = vgetq_lane_u64(mask, 0) & 1;
+        passed[row + 1] = vgetq_lane_u64(mask, 1) & 1;
+      }
+#endif
+      // Scalar fallback and remainder
+      for (; row < rows; row++) {
+        double avg = period[0][row] * weight[0];
+        for (size_t i = 1; i < Components; i++) avg = GradingPolicy::multiplyAdd(period[i][row], weight[i], avg);
+        average[row] = avg;
+        passed[row] = avg >= policy.passingGrade();
+      }
+    }
+
+    /**
+     * @struct Grade
+     * @brief Represents a single grade with name and value
+     */
+    struct Grade {
+      string name;    // Name of the grading period (e.g., "Prelim")
+      double value;   // Numerical grade value (0-100)
+    };
+
+    static constexpr size_t OUTPUT_BLOCK_SIZE = 1 << 16;  // Bytes buffered before each batch write
+    static constexpr size_t ROW_BLOCK_SIZE = 8192;        // Students parsed into GradeColumns per kernel pass
+    static constexpr size_t CHUNK_SIZE = 1 << 20;         // Roster bytes handed to one chunk task
+
+    GradingPolicy policy;   // Periods, weights, passing grade and bands every path grades with
+
+    // Reads "ID,<one field per policy period>"; Bounded = false leaves the grade range to validateColumn()
+    template < bool Bounded >
+    static bool readStudentLine(FieldReader& reader, const GradingPolicy& policy, string_view& id, double values[]) {
+      bool valid = reader.nextField(id, "student ID");
+      for (size_t i = 0; valid && i < policy.components(); i++) {
+        valid = Bounded ? reader.nextDouble<MIN_GRADE, MAX_GRADE>(values[i], policy.label(i))
+                        : reader.nextNumber(values[i], policy.label(i));
+      }
+      return valid && reader.expectLineEnd();
+    }
+
+  public:
+    /**
+     * @brief Creates an evaluator grading by the given policy
+     * @param gradingPolicy Periods, weights, passing grade and bands (the standard four periods by default)
+     */
+    explicit StudentGradeEvaluator(GradingPolicy gradingPolicy = GradingPolicy::standard()) : policy(move(gradingPolicy)) {}
+
+    // @brief Returns the policy this evaluator grades by.
+    const GradingPolicy& gradingPolicy() const { return policy; }
+
+    /**
+     * @brief Runs the Student Grade Evaluator activity
+     * 
+     * Prompts for one grade per policy period (Prelim, Midterm, PreFinal,
+     * Final by default), calculates the weighted average, and displays
+     * pass/fail status, plus the letter grade if the policy has bands.
+     */
+    Task<> runStudentGradeEvaluator(Session& session) const {
+      UI::header(session.out, "Student Grade Evaluator");
+
+      // Initialize grade entries with names and default values
+      Grade gradeList[GradingPolicy::MAX_COMPONENTS];
+      double values[GradingPolicy::MAX_COMPONENTS] = {};
+      pmr::string prompt(session.arena().resource());
+
+      // Collect and validate each grade
+      for (size_t i = 0; i < policy.components(); i++) {
+        gradeList[i] = {string(policy.name(i)), 0};
+        prompt.assign("Enter ").append(gradeList[i].name).append(" Grade: ");
+        gradeList[i].value = co_await InputValidator::getValidatedDouble<MIN_GRADE, MAX_GRADE>(session, prompt);
+        values[i] = gradeList[i].value;
+      }
+
+      // Calculate average grade
+      double average = policy.average(values);
+      Metrics::count(Counter::StudentsEvaluated);
+
+      // Display results with formatting (a whole passing grade prints like the int it used to be)
+      const double passingGrade = policy.passingGrade();
+      UI::line(session.out);
+      session.out << "Passing grade: ";
+      if (passingGrade == floor(passingGrade)) session.out << static_cast<int>(passingGrade) << "\n";
+      else session.out << passingGrade << "\n";
+      session.out << "Your average: " << average << "\n";
+      if (policy.hasBands()) session.out << "Letter grade: " << policy.letter(policy.bandOf(average)) << "\n";
+      session.out << "REMARKS: ";
+
+      // Determine and display pass/fail status
+      if (average >= passingGrade) {
+        UI::header(session.out, "PASADO KA BOI!!");
+      } else {
+        UI::header(session.out, "BAGSAK KA BOI!!");
+      }
+      UI::line(session.out);
+
+      co_await UI::pauseBuffer(session);
+    };
+
+    /**
+     * @brief Evaluates one student from a script line without prompting
+     * @param args Reader positioned after the command word, holding one grade per policy period
+     * @param out Receives "Average,Remarks", e.g. "81.25,PASSED", then ",<letter>" if the policy has bands
+     * @return false (with the reason in args.error()) if a grade is missing or invalid
+     *
+     * Averages with GradingPolicy::average(), like runStudentGradeEvaluator(),
+     * so the average is identical to the one the menu shows.
+     */
+    bool evaluateCommand(FieldReader& args, OutputWriter& out) const {
+      Metrics::ScopedTimer timer(Timer::GradeEvaluation);
+      double values[GradingPolicy::MAX_COMPONENTS] = {};
+      for (size_t i = 0; i < policy.components(); i++) {
+        if (!args.nextDouble<MIN_GRADE, MAX_GRADE>(values[i], policy.label(i))) return false;
+      }
+      if (!args.expectLineEnd()) return false;
+
+      double average = policy.average(values);
+      Metrics::count(Counter::StudentsEvaluated);
+      char number[32];
+      out.write(number, static_cast<size_t>(to_chars(number, number + sizeof(number), average, chars_format::general, 6).ptr - number));
+      if (!policy.hasBands()) {
+        out.write(average >= policy.passingGrade() ? ",PASSED\n" : ",FAILED\n");
+        return true;
+      }
+      out.write(average >= policy.passingGrade() ? ",PASSED," : ",FAILED,");
+      out.write(policy.letter(policy.bandOf(average)));
+      out.put('\n');
+      return true;
+    }
+
+    /**
+     * @struct RosterChunk
+     * @brief Output of evaluating one newline-aligned slice of a roster
+     *
+     * Error line numbers are relative to the chunk; the caller adds the
+     * number of lines in earlier chunks when it writes them out. Columnar
+     * results stay as rows, since where a slice ends depends on how the
+     * roster was cut; the writer groups them into record batches.
+     */
+    struct RosterChunk {
+      string output;                // "ID,Average,Remarks" lines for this slice
+      GradeColumns records;         // Evaluated rows for the columnar format (no period columns)
+      vector<ParseError> errors;    // Rejected lines, numbered within the chunk
+      size_t lines = 0;             // Lines consumed, including blank and rejected ones
+      RosterSummary summary;
+    };
+
+    // Appends row's "ID,Average,Remarks" line (plus ",<letter>" with bands) from an evaluated block
+    static void appendResultLine(string& out, const GradeColumns& columns, size_t row, const GradingPolicy& policy) {
+      // Same formatting as "Your average: " in the interactive mode (%g, 6 digits)
+      char number[32];
+      char* numberEnd = to_chars(number, number + sizeof(number), columns.average[row], chars_format::general, 6).ptr;
+
+      string_view id = columns.id(row);
+      out.append(id.data(), id.size());
+      out += ',';
+      out.append(number, numberEnd);
+      if (!policy.hasBands()) {
+        out += columns.passed[row] ? ",PASSED\n" : ",FAILED\n";
+        return;
+      }
+      out += columns.passed[row] ? ",PASSED," : ",FAILED,";
+      out.append(policy.letter(columns.band[row])) += '\n';
+    }
+
+    /**
+     * @brief Parses, evaluates and formats one roster slice
+     * @param text Whole lines of roster text (the last newline may be missing)
+     * @param isFirstChunk true if the slice starts at line 1 and may hold the header
+     * @param result Receives the formatted lines (or columnar rows), errors and counts
+     * @param format Text "ID,Average,Remarks" lines, or rows for RecordBatcher
+     * @param policy Periods, weights and bands to grade with
+     *
+     * This is the only place roster lines are turned into results, which
+     * is what keeps the single-threaded and parallel paths byte-identical.
+     *
+     * Grades are parsed without range checks; each block's period columns
+     * are then range-checked in bulk with InputValidator::validateColumn().
+     * Only rejected lines are re-read with the per-field validators, to
+     * report the same first error as before.
+     */
+    static void evaluateChunk(string_view text, bool isFirstChunk, RosterChunk& result, ResultFormat format = ResultFormat::Text,
+                              const GradingPolicy& policy = GradingPolicy::standard()) {
+      const size_t components = policy.components();
+      GradeColumns columns;
+      columns.components = components;
+      vector<string_view> rowLines;     // Source line of each row in the block
+      vector<size_t> rowLineNumbers;
+      vector<uint64_t> validBits, periodBits;
+      result.records.components = 0;
+      if (format == ResultFormat::Text) result.output.reserve(text.size() / 2);
+
+      // Re-reads a rejected line with every check in field order and records its first error
+      auto reject = [&](string_view line, size_t lineNumber) {
+        FieldReader strict(line);
+        strict.nextLine();
+        string_view id;
+        double values[GradingPolicy::MAX_COMPONENTS];
+        readStudentLine<true>(strict, policy, id, values);
+        result.errors.push_back(strict.error());
+        result.errors.back().line = lineNumber;
+        result.summary.rejected++;
+      };
+
+      // Runs the kernel over the parsed block and appends its result lines
+      auto flushBlock = [&]() {
+        Metrics::ScopedTimer timer(Timer::GradeEvaluation);
+        const size_t rows = columns.size();
+        const size_t evaluatedBefore = result.summary.evaluated;
+        const size_t words = (rows + 63) / 64;
+        validBits.assign(words, ~uint64_t(0));
+        periodBits.resize(words);
+        size_t invalid = 0;
+        for (size_t i = 0; i < components; i++) {
+          if (InputValidator::validateColumn<MIN_GRADE, MAX_GRADE>(columns.period[i], periodBits.data()) == 0) continue;
+          for (size_t word = 0; word < words; word++) validBits[word] &= periodBits[word];
+          invalid = 1;
+        }
+
+        evaluateColumns(columns, policy);
+
+        // Whole columns feed the moments unless some rows have to be left out
+        CohortStatistics& statistics = result.summary.statistics;
+        if (!invalid) {
+          for (size_t i = 0; i < components; i++) statistics.period[i].addBlock(columns.period[i].data(), rows);
+          statistics.average.addBlock(columns.average.data(), rows);
+        }
+
+        for (size_t row = 0; row < rows; row++) {
+          if (invalid && !((validBits[row / 64] >> (row % 64)) & 1)) {
+            reject(rowLines[row], rowLineNumbers[row]);
+            continue;
+          }
+          if (invalid) {
+            for (size_t i = 0; i < components; i++) statistics.period[i].add(columns.period[i][row]);
+            statistics.average.add(columns.average[row]);
+          }
+          statistics.addAverage(columns.average[row]);
+          result.summary.passed += columns.passed[row];
+          result.summary.evaluated++;
+          if (format != ResultFormat::Text) continue;
+
+          appendResultLine(result.output, columns, row, policy);
+        }
+
+        if (format == ResultFormat::Columnar) {
+          if (invalid) columns.keepRows(validBits.data());
+          result.records.appendRows(columns, 0, columns.size());
+        }
+        Metrics::count(Counter::StudentsEvaluated, result.summary.evaluated - evaluatedBefore);
+
+        columns.clear();
+        rowLines.clear();
+        rowLineNumbers.clear();
+      };
+
+      FieldReader reader(text);
+      while (reader.nextLine()) {
+        if (reader.isBlankLine()) continue;
+
+        // Skip an optional column header on the first line
+        if (isFirstChunk && reader.currentLineNumber() == 1 && FieldReader::isHeaderLine(reader.line(), "ID")) continue;
+
+        string_view line = reader.line();
+        string_view id;
+        double values[GradingPolicy::MAX_COMPONENTS];
+        if (!readStudentLine<false>(reader, policy, id, values)) {
+          reject(line, reader.currentLineNumber());
+          continue;
+        }
+
+        columns.append(id, values);
+        rowLines.push_back(line);
+        rowLineNumbers.push_back(reader.currentLineNumber());
+        if (columns.size() == ROW_BLOCK_SIZE) flushBlock();
+      }
+      flushBlock();
+
+      // Range rejections are found a block at a time; report every error in line order
+      stable_sort(result.errors.begin(), result.errors.end(),
+                  [](const ParseError& a, const ParseError& b) { return a.line < b.line; });
+      result.lines = reader.currentLineNumber();
+    }
+
+    /**
+     * @brief Writes what precedes the results: the CSV header line or the columnar schema
+     *
+     * The columnar schema is id (Utf8), average (Float64) and passed (UInt8, 1 or 0),
+     * then grade (Utf8 letter) if the policy has bands, as is the text "Grade" column.
+     */
+    static void writeResultHeader(ostream& out, ResultFormat format, const GradingPolicy& policy = GradingPolicy::standard()) {
+      if (format == ResultFormat::Text) {
+        out << (policy.hasBands() ? "ID,Average,Remarks,Grade\n" : "ID,Average,Remarks\n");
+        return;
+      }
+      const ColumnarFormat::ColumnDescriptor schema[] = {
+        ColumnarFormat::column("id", ColumnarFormat::ColumnType::Utf8),
+        ColumnarFormat::column("average", ColumnarFormat::ColumnType::Float64),
+        ColumnarFormat::column("passed", ColumnarFormat::ColumnType::UInt8),
+        ColumnarFormat::column("grade", ColumnarFormat::ColumnType::Utf8),
+      };
+      string header;
+      ColumnarFormat::appendSchema(header, span(schema, policy.hasBands() ? 4 : 3));
+      out.write(header.data(), static_cast<streamsize>(header.size()));
+    }
+
+    // Copies an evaluated block's ID, average, passed (and letter) columns into one record batch
+    static void appendRecordBatch(string& out, const GradeColumns& columns, const GradingPolicy& policy) {
+      const size_t rows = columns.size();
+      size_t batch = ColumnarFormat::beginBatch(out, rows);
+      ColumnarFormat::appendBuffer(out, columns.idOffsets.data(), (rows + 1) * sizeof(uint32_t));
+      ColumnarFormat::appendBuffer(out, columns.idBytes.data(), columns.idBytes.size());
+      ColumnarFormat::appendBuffer(out, columns.average.data(), rows * sizeof(double));
+      ColumnarFormat::appendBuffer(out, columns.passed.data(), rows * sizeof(uint8_t));
+      if (policy.hasBands()) {
+        thread_local vector<uint32_t> letterOffsets;
+        thread_local string letterBytes;
+        letterOffsets.assign(1, 0);
+        letterBytes.clear();
+        for (size_t row = 0; row < rows; row++) {
+          letterBytes.append(policy.letter(columns.band[row]));
+          letterOffsets.push_back(static_cast<uint32_t>(letterBytes.size()));
+        }
+        ColumnarFormat::appendBuffer(out, letterOffsets.data(), (rows + 1) * sizeof(uint32_t));
+        ColumnarFormat::appendBuffer(out, letterBytes.data(), letterBytes.size());
+      }
+      ColumnarFormat::endBatch(out, batch);
+    }
+
+    /**
+     * @class RecordBatcher
+     * @brief Regroups columnar rows into record batches of exactly ROW_BLOCK_SIZE rows
+     *
+     * Every batch but the last is full, whatever the chunk boundaries, so
+     * the streaming, mapped and parallel paths write identical columnar
+     * output at any thread count.
+     */
+    class RecordBatcher {
+      public:
+        explicit RecordBatcher(const GradingPolicy& policy) : policy(policy) { pending.components = 0; }
+
+        // @brief Takes a chunk's rows, writing each batch that fills up.
+        void add(const GradeColumns& rows, ostream& out) {
+          for (size_t first = 0; first < rows.size();) {
+            size_t last = min(rows.size(), first + ROW_BLOCK_SIZE - pending.size());
+            pending.appendRows(rows, first, last);
+            first = last;
+            if (pending.size() == ROW_BLOCK_SIZE) write(out);
+          }
+        }
+
+        // @brief Writes the final, partial batch.
+        void finish(ostream& out) {
+          if (pending.size() > 0) write(out);
+        }
+
+      private:
+        const GradingPolicy& policy;
+        GradeColumns pending;
+        string encoded;
+
+        void write(ostream& out) {
+          appendRecordBatch(encoded, pending, policy);
+          out.write(encoded.data(), static_cast<streamsize>(encoded.size()));
+          encoded.clear();
+          pending.clear();
+        }
+    };
+
+    /**
+     * @brief Writes a finished chunk and advances the running line count
+     */
+    static void writeChunk(const RosterChunk& chunk, size_t& lineBase, ostream& out, ostream& errors, RecordBatcher& batcher) {
+      for (const ParseError& error : chunk.errors) {
+        errors << "[ERROR] Line " << (lineBase + error.line) << ", column " << error.column << ": " << error.message << "\n";
+      }
+      out.write(chunk.output.data(), chunk.output.size());
+      batcher.add(chunk.records, out);
+      lineBase += chunk.lines;
+    }
+
+    /**
+     * @brief Evaluates a whole roster without prompting
+     * @param in Roster stream, one "ID,<one grade per policy period>" line per student
+     * @param out Destination for the "ID,Average,Remarks" result lines
+     * @param errors Destination for per-line rejection messages
+     * @param format Text lines or the columnar format (see writeResultHeader())
+     * @return Counts of evaluated, passed and rejected students
+     *
+     * Applies the same bounds, policy and averaging as the interactive
+     * evaluator. An optional "ID,..." header line and blank lines are skipped.
+     * The stream is read in CHUNK_SIZE blocks and results are written one
+     * block at a time, so the stream is never flushed per student.
+     */
+    RosterSummary evaluateRoster(istream& in, ostream& out, ostream& errors, ResultFormat format = ResultFormat::Text) {
+      RosterSummary summary;
+      size_t lineBase = 0;
+      bool isFirstChunk = true;
+      RecordBatcher batcher(policy);
+      writeResultHeader(out, format, policy);
+
+      string pending;
+      vector<char> block(CHUNK_SIZE);
+      while (true) {
+        in.read(block.data(), block.size());
+        size_t bytesRead = static_cast<size_t>(in.gcount());
+        pending.append(block.data(), bytesRead);
+
+        // Keep a trailing partial line for the next read unless input has ended
+        bool atEnd = bytesRead < block.size();
+        size_t cut = atEnd ? pending.size() : pending.rfind('\n');
+        if (cut == string::npos) continue;
+        if (!atEnd) cut++;
+
+        RosterChunk chunk;
+        evaluateChunk(string_view(pending).substr(0, cut), isFirstChunk, chunk, format, policy);
+        writeChunk(chunk, lineBase, out, errors, batcher);
+        summary.merge(chunk.summary);
+        isFirstChunk = false;
+        pending.erase(0, cut);
+
+        if (atEnd) break;
+      }
+
+      batcher.finish(out);
+      out.flush();
+      return summary;
+    }
+
+    /**
+     * @brief Evaluates an in-memory (typically memory-mapped) roster
+     * @param text The complete roster text
+     * @param out Destination for the "ID,Average,Remarks" result lines
+     * @param errors Destination for per-line rejection messages
+     * @param pool Workers that evaluate the chunks, or nullptr to run on the calling thread
+     * @param format Text lines or the columnar format (see writeResultHeader())
+     * @return Counts of evaluated, passed and rejected students
+     *
+     * The text is cut at newlines into chunks that are evaluated
+     * independently and written back strictly in input order, so the
+     * output is byte-identical to the streaming evaluateRoster(). At most
+     * a few chunks per worker are in flight, which bounds the buffered output.
+     */
+    RosterSummary evaluateRoster(string_view text, ostream& out, ostream& errors, WorkStealingPool* pool,
+                                 ResultFormat format = ResultFormat::Text) {
+      RosterSummary summary;
+      size_t lineBase = 0;
+      RecordBatcher batcher(policy);
+      writeResultHeader(out, format, policy);
+
+      if (pool == nullptr) {
+        bool isFirstChunk = true;
+        while (!text.empty()) {
+          size_t newline = text.find('\n', min(CHUNK_SIZE, text.size()) - 1);
+          size_t cut = (newline == string_view::npos) ? text.size() : newline + 1;
+
+          RosterChunk chunk;
+          evaluateChunk(text.substr(0, cut), isFirstChunk, chunk, format, policy);
+          writeChunk(chunk, lineBase, out, errors, batcher);
+          summary.merge(chunk.summary);
+          isFirstChunk = false;
+          text.remove_prefix(cut);
+        }
+
+        batcher.finish(out);
+        out.flush();
+        return summary;
+      }
+
+      // Enough chunks per worker for stealing to even out slow slices
+      size_t chunkSize = max<size_t>(1 << 16, min<size_t>(CHUNK_SIZE, text.size() / (pool->size() * 8) + 1));
+      vector<string_view> slices;
+      while (!text.empty()) {
+        size_t cut = min(chunkSize, text.size());
+        size_t newline = text.find('\n', cut - 1);
+        cut = (newline == string_view::npos) ? text.size() : newline + 1;
+        slices.push_back(text.substr(0, cut));
+        text.remove_prefix(cut);
+      }
+
+      vector<RosterChunk> chunks(slices.size());
+      vector<promise<void>> finished(slices.size());
+      const size_t window = pool->size() * 4;
+
+      auto submitChunk = [&](size_t index) {
+        pool->submit([&, index]() {
+          evaluateChunk(slices[index], index == 0, chunks[index], format, policy);
+          finished[index].set_value();
+        });
+      };
+
+      size_t submitted = 0;
+      for (; submitted < slices.size() && submitted < window; submitted++) submitChunk(submitted);
+
+      for (size_t index = 0; index < slices.size(); index++) {
+        finished[index].get_future().wait();
+        if (submitted < slices.size()) submitChunk(submitted++);
+
+        writeChunk(chunks[index], lineBase, out, errors, batcher);
+        summary.merge(chunks[index].summary);
+        RosterChunk().output.swap(chunks[index].output);   // release the written block
+        chunks[index].records = GradeColumns();
+        vector<uint64_t>().swap(chunks[index].summary.statistics.histogram);
+      }
+
+      batcher.finish(out);
+      out.flush();
+      return summary;
+    }
+
+    /**
+     * @class IncrementalRoster
+     * @brief An evaluated roster kept in memory and corrected one grade at a time
+     *
+     * load() grades the roster once with the batch kernel and indexes every
+     * student ID to its GradeColumns row in an open-addressed table of row
+     * numbers (no node per student). update() then rewrites one period
+     * of one row, re-averages just that row with GradingPolicy::average()
+     * (bit-identical to the kernel) and adjusts the summary in place: the
+     * pass count and histogram bucket move by one and the moments go
+     * through RunningMoments::replace(). A correction costs O(periods),
+     * whatever the roster size.
+     *
+     * The moments are therefore updated rather than recomputed and may
+     * drift from a fresh batch run in the last few digits.
+     */
+    class IncrementalRoster {
+      public:
+        static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+        explicit IncrementalRoster(const GradingPolicy& gradingPolicy) : policy(gradingPolicy) {
+          columns.components = policy.components();
+        }
+
+        /**
+         * @brief Parses and evaluates a whole roster, replacing any loaded before
+         * @param text Roster text, one "ID,<one grade per policy period>" line per student
+         * @param errors Receives the rejected lines, in line order
+         *
+         * Lines are checked like the batch evaluator checks them. A student
+         * ID seen on an earlier line is rejected too, since an update must
+         * name exactly one row.
+         */
+        void load(string_view text, vector<ParseError>& errors) {
+          columns.clear();
+          slots.assign(MIN_SLOTS, 0);
+          totals = RosterSummary();
+
+          FieldReader reader(text);
+          while (reader.nextLine()) {
+            if (reader.isBlankLine()) continue;
+            if (reader.currentLineNumber() == 1 && FieldReader::isHeaderLine(reader.line(), "ID")) continue;
+
+            string_view id;
+            double values[GradingPolicy::MAX_COMPONENTS];
+            if (!readStudentLine<true>(reader, policy, id, values)) {
+              errors.push_back(reader.error());
+              totals.rejected++;
+              continue;
+            }
+
+            uint32_t& slot = slots[slotOf(id)];
+            if (slot != 0) {
+              errors.push_back({reader.currentLineNumber(), 1, "duplicate student ID"});
+              totals.rejected++;
+              continue;
+            }
+            slot = static_cast<uint32_t>(columns.size() + 1);
+            columns.append(id, values);
+            if (columns.size() * 2 > slots.size()) grow();
+          }
+
+          {
+            Metrics::ScopedTimer timer(Timer::GradeEvaluation);
+            evaluateColumns(columns, policy);
+          }
+          const size_t students = columns.size();
+          CohortStatistics& statistics = totals.statistics;
+          for (size_t i = 0; i < columns.components; i++) statistics.period[i].addBlock(columns.period[i].data(), students);
+          statistics.average.addBlock(columns.average.data(), students);
+          for (size_t row = 0; row < students; row++) {
+            statistics.addAverage(columns.average[row]);
+            totals.passed += columns.passed[row];
+          }
+          totals.evaluated = students;
+          Metrics::count(Counter::StudentsEvaluated, students);
+        }
+
+        // @brief Returns the row of a student ID, or NOT_FOUND.
+        size_t find(string_view id) const {
+          const size_t entry = slots[slotOf(id)];
+          return entry == 0 ? NOT_FOUND : entry - 1;
+        }
+
+        /**
+         * @brief Sets one period of one student and re-grades that student alone
+         * @param row Row from find()
+         * @param component Period index in policy order
+         * @param value New grade, already within MIN_GRADE..MAX_GRADE
+         */
+        void update(size_t row, size_t component, double value) {
+          CohortStatistics& statistics = totals.statistics;
+          statistics.period[component].replace(columns.period[component][row], value);
+          columns.period[component][row] = value;
+
+          double values[GradingPolicy::MAX_COMPONENTS];
+          for (size_t i = 0; i < columns.components; i++) values[i] = columns.period[i][row];
+          const double average = policy.average(values);
+          const uint8_t passed = average >= policy.passingGrade() ? 1 : 0;
+
+          statistics.replaceAverage(columns.average[row], average);
+          totals.passed = totals.passed - columns.passed[row] + passed;
+          columns.average[row] = average;
+          columns.passed[row] = passed;
+          if (policy.hasBands()) columns.band[row] = static_cast<uint8_t>(policy.bandOf(average));
+          Metrics::count(Counter::StudentsEvaluated);
+        }
+
+        /**
+         * @brief Reads one "ID,Period,Grade" correction and applies it
+         * @param reader Positioned on the line (after nextLine())
+         * @return The updated row, or NOT_FOUND with the reason in reader.error()
+         *
+         * Period is a policy period name (e.g. "Final") or its 1-based
+         * column number. The grade is checked like a roster grade.
+         */
+        size_t apply(FieldReader& reader) {
+          string_view id, period;
+          if (!reader.nextField(id, "student ID")) return NOT_FOUND;
+          const size_t row = find(id);
+          if (row == NOT_FOUND) {
+            reader.rejectField("unknown student ID");
+            return NOT_FOUND;
+          }
+          if (!reader.nextField(period, "period")) return NOT_FOUND;
+          const size_t component = componentOf(period);
+          if (component == NOT_FOUND) {
+            reader.rejectField("period must be a policy period name or 1-" + to_string(policy.components()));
+            return NOT_FOUND;
+          }
+          double value;
+          if (!reader.nextDouble<MIN_GRADE, MAX_GRADE>(value, policy.label(component)) || !reader.expectLineEnd()) return NOT_FOUND;
+
+          update(row, component, value);
+          return row;
+        }
+
+        // @brief Appends a row's current "ID,Average,Remarks" line, as the batch evaluator writes it.
+        void appendRow(string& out, size_t row) const { appendResultLine(out, columns, row, policy); }
+
+        // @brief Returns the totals and cohort statistics as of the last update.
+        const RosterSummary& summary() const { return totals; }
+
+      private:
+        static constexpr size_t MIN_SLOTS = 1024;
+
+        const GradingPolicy& policy;
+        GradeColumns columns;
+        vector<uint32_t> slots;   // Open-addressed ID index: row + 1, or 0 for an empty slot; at most half full
+        RosterSummary totals;
+
+        static uint64_t hash(string_view id) {
+          uint64_t value = 14695981039346656037ULL;   // FNV-1a
+          for (char c : id) value = (value ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+          return value;
+        }
+
+        // Returns the position of id's slot, or of the empty slot where it belongs (probing linearly)
+        size_t slotOf(string_view id) const {
+          const size_t mask = slots.size() - 1;
+          size_t slot = hash(id) & mask;
+          while (slots[slot] != 0 && columns.id(slots[slot] - 1) != id) slot = (slot + 1) & mask;
+          return slot;
+        }
+
+        // Doubles the index and re-inserts every row
+        void grow() {
+          slots.assign(slots.size() * 2, 0);
+          const size_t mask = slots.size() - 1;
+          for (size_t row = 0; row < columns.size(); row++) {
+            size_t slot = hash(columns.id(row)) & mask;
+            while (slots[slot] != 0) slot = (slot + 1) & mask;
+            slots[slot] = static_cast<uint32_t>(row + 1);
+          }
+        }
+
+        size_t componentOf(string_view period) const {
+          for (size_t i = 0; i < policy.components(); i++) {
+            if (policy.name(i) == period) return i;
+          }
+          size_t number = 0;
+          auto [end, status] = from_chars(period.data(), period.data() + period.size(), number);
+          if (status != errc() || end != period.data() + period.size() || number < 1 || number > policy.components()) return NOT_FOUND;
+          return number - 1;
+        }
+    };
+
+    /**
+     * @brief Writes the cohort report of a roster run
+     * @param out Destination (the batch mode uses standard error)
+     * @param summary Totals returned by evaluateRoster()
+     *
+     * Shows the pass rate, the mean and standard deviation of every period
+     * and of the average, approximate percentiles, and a histogram of the
+     * averages in 10-point bands.
+     */
+    void writeStatistics(ostream& out, const RosterSummary& summary) const {
+      const CohortStatistics& statistics = summary.statistics;
+      const double passRate = summary.evaluated > 0 ? 100.0 * static_cast<double>(summary.passed) / static_cast<double>(summary.evaluated) : 0;
+      const int BAR_WIDTH = 40;   // Characters of the largest histogram band
+
+      out << fixed << setprecision(2);
+      out << "Cohort: " << summary.evaluated << " students, pass rate " << passRate << "%\n";
+      out << left << setw(10) << "Period" << right << setw(10) << "Mean" << setw(10) << "StdDev" << "\n";
+      for (size_t i = 0; i < policy.components(); i++) {
+        out << left << setw(10) << policy.name(i) << right << setw(10) << statistics.period[i].mean
+            << setw(10) << statistics.period[i].standardDeviation() << "\n";
+      }
+      out << left << setw(10) << "Average" << right << setw(10) << statistics.average.mean
+          << setw(10) << statistics.average.standardDeviation() << "\n";
+
+      out << "Percentiles of the average:";
+      for (int p : {10, 25, 50, 75, 90}) out << " p" << p << " " << statistics.percentile(p);
+      out << "\n";
+
+      uint64_t largest = 1;
+      for (int from = MIN_GRADE; from < MAX_GRADE; from += 10) largest = max(largest, statistics.countBetween(from, from + 10));
+      for (int from = MIN_GRADE; from < MAX_GRADE; from += 10) {
+        uint64_t students = statistics.countBetween(from, from + 10);
+        size_t bar = static_cast<size_t>(students * BAR_WIDTH / largest);
+        out << right << setw(3) << from << "-" << left << setw(3) << (from + 10) << right << setw(12) << students
+            << (bar > 0 ? " " : "") << string(bar, '#') << "\n";
+      }
+      out << defaultfloat << setprecision(6);
+    }
+};
+
+// ================================================== TRIANGLE ACTIVITY CLASS =================================================
+/**
+ * @class TriangleActivity
+ * @brief Generates and displays triangle patterns using asterisks
+ * 
+ * This class provides an interactive interface for creating
+ * right-aligned and inverted triangle patterns of specified heights.
+ */
+class TriangleActivity {
+  public:
+    static constexpr int MIN_HEIGHT = 1;                 // Smallest triangle height
+    static constexpr int MAX_HEIGHT = 20;                // Largest height offered by the interactive menu
+    static constexpr int MAX_RENDER_HEIGHT = 1000000;    // Largest height accepted outside the interactive menu
+
+    /**
+     * @class RowCache
+     * @brief One precomputed run of stars that every row is sliced from
+     *
+     * A row of n stars plus its newline is the last n + 1 bytes of the
+     * cached line, so rows are served as (pointer, length) views with no
+     * per-row formatting. One cache serves both triangle shapes.
+     */
+    class RowCache {
+      public:
+        explicit RowCache(int maxHeight) : line(static_cast<size_t>(maxHeight), '*') { line += '\n'; }
+
+        // @brief Returns the tallest triangle this cache can serve.
+        int maxHeight() const { return static_cast<int>(line.size()) - 1; }
+
+        // @brief Returns "stars" asterisks followed by a newline.
+        string_view row(int stars) const { return string_view(line).substr(line.size() - static_cast<size_t>(stars) - 1); }
+
+      private:
+        string line;
+    };
+
+    /**
+     * @brief Writes a right-aligned triangle pattern
+     * @param out Destination writer
+     * @param rows Cache at least height stars wide
+     * @param height The number of rows in the triangle
+     * 
+     * Example (height = 3):
+     * *
+     * **
+     * ***
+     */
+    static void displayRightTriangle(OutputWriter& out, const RowCache& rows, int height) {
+      writeRows(out, rows, height, false);
+    }
+    
+    /**
+     * @brief Writes an inverted triangle pattern
+     * @param out Destination writer
+     * @param rows Cache at least height stars wide
+     * @param height The number of rows in the triangle
+     * 
+     * Example (height = 3):
+     * ***
+     * **
+     * *
+     */
+    static void displayInvertedTriangle(OutputWriter& out, const RowCache& rows, int height) {
+      writeRows(out, rows, height, true);
+    }
+
+    /**
+     * @brief Byte offset at which row i starts
+     * @param i Row index (0-based); i == height gives the pattern size
+     * @param height Rows in the triangle
+     * @param inverted false for the right triangle, true for the inverted one
+     *
+     * Right rows hold i + 1 stars and a newline, so row i starts at
+     * i(i+1)/2 + i. Inverted rows hold height - i stars and a newline,
+     * so row i starts at i(height+1) - i(i-1)/2.
+     */
+    static uint64_t rowOffset(uint64_t i, uint64_t height, bool inverted) {
+      return inverted ? i * (height + 1) - i * (i - 1) / 2 : i * (i + 1) / 2 + i;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    /**
+     * @brief Renders one triangle into a file in parallel
+     * @param fd File opened for writing; it is extended to fit if needed
+     * @param rows Cache at least height stars wide
+     * @param height The number of rows in the triangle
+     * @param inverted false for the right triangle, true for the inverted one
+     * @param baseOffset File offset where the pattern starts
+     * @param pool Workers that render the segments
+     * @return false if any write failed
+     *
+     * The rows are split into byte-balanced segments, several per worker.
+     * Each segment knows its file offset from rowOffset(), so workers
+     * pwrite() straight into place with no ordering between them.
+     */
+    static bool renderToFile(int fd, const RowCache& rows, int height, bool inverted, uint64_t baseOffset, WorkStealingPool& pool) {
+      const uint64_t totalBytes = rowOffset(height, height, inverted);
+      if (ftruncate(fd, static_cast<off_t>(baseOffset + totalBytes)) != 0) return false;
+
+      const size_t segments = min<size_t>(static_cast<size_t>(height), pool.size() * 4);
+      latch finished(static_cast<ptrdiff_t>(segments));
+      atomic<bool> failed{false};
+
+      int first = 0;
+      for (size_t segment = 0; segment < segments; segment++) {
+        int last = (segment + 1 == segments) ? height : firstRowAtOrAfter(totalBytes * (segment + 1) / segments, height, inverted);
+        pool.submit([&, first, last]() {
+          if (!writeSegment(fd, rows, height, inverted, baseOffset, first, last)) failed = true;
+          finished.count_down();
+        });
+        first = last;
+      }
+
+      finished.wait();
+      return !failed;
+    }
+#endif
+
+  private:
+    static constexpr size_t SLICE_ROW_BYTES = 1024;   // Rows at least this long are handed to writev() uncopied
+    static constexpr size_t SEGMENT_BUFFER_SIZE = 1 << 20;   // Bytes each worker assembles per pwrite()
+    static constexpr size_t SLICE_BATCH = 1024;       // Row slices gathered per writeSlices() call
+
+    RowCache menuRows{MAX_HEIGHT};                    // Shared by every pattern the menu renders
+
+    // Short rows are copied into the writer's buffer; long rows go out as slices of the cache
+    static void writeRows(OutputWriter& out, const RowCache& rows, int height, bool inverted) {
+      Metrics::ScopedTimer timer(Timer::TriangleRender);
+      Metrics::count(Counter::TriangleRenders);
+      string_view batch[SLICE_BATCH];
+      size_t batched = 0;
+
+      for (int i = 0; i < height; i++) {
+        string_view row = rows.row(inverted ? height - i : i + 1);
+        if (row.size() < SLICE_ROW_BYTES) {
+          if (batched > 0) out.writeSlices(batch, batched);
+          batched = 0;
+          out.write(row);
+          continue;
+        }
+
+        batch[batched++] = row;
+        if (batched == SLICE_BATCH) {
+          out.writeSlices(batch, batched);
+          batched = 0;
+        }
+      }
+      if (batched > 0) out.writeSlices(batch, batched);
+    }
+
+    // Smallest row index whose start offset is >= target
+    static int firstRowAtOrAfter(uint64_t target, int height, bool inverted) {
+      int low = 0, high = height;
+      while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (rowOffset(middle, height, inverted) < target) low = middle + 1;
+        else high = middle;
+      }
+      return low;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // pwrite() that retries partial writes
+    static bool writeAt(int fd, const char* data, size_t length, uint64_t offset) {
+      while (length > 0) {
+        ssize_t written = ::pwrite(fd, data, length, static_cast<off_t>(offset));
+        if (written < 0) {
+          if (errno == EINTR) continue;
+          return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+      }
+      return true;
+    }
+
+    // Writes rows [first, last) at their closed-form offsets
+    static bool writeSegment(int fd, const RowCache& rows, int height, bool inverted, uint64_t baseOffset, int first, int last) {
+      string buffer;
+      buffer.reserve(SEGMENT_BUFFER_SIZE);
+      uint64_t offset = baseOffset + rowOffset(first, height, inverted);
+
+      for (int i = first; i < last; i++) {
+        string_view row = rows.row(inverted ? height - i : i + 1);
+        if (buffer.size() + row.size() > SEGMENT_BUFFER_SIZE) {
+          if (!writeAt(fd, buffer.data(), buffer.size(), offset)) return false;
+          offset += buffer.size();
+          buffer.clear();
+        }
+        if (row.size() > SEGMENT_BUFFER_SIZE) {
+          // Long rows go straight from the cache
+          if (!writeAt(fd, row.data(), row.size(), offset)) return false;
+          offset += row.size();
+          continue;
+        }
+        buffer.append(row.data(), row.size());
+      }
+      return writeAt(fd, buffer.data(), buffer.size(), offset);
+    }
+#endif
+
+    // Renders one pattern through the session output for the interactive menu
+    void displayRightTriangle(ostream& stream, int height) const {
+      OutputWriter out(stream);
+      displayRightTriangle(out, menuRows, height);
+    }
+
+    void displayInvertedTriangle(ostream& stream, int height) const {
+      OutputWriter out(stream);
+      displayInvertedTriangle(out, menuRows, height);
+    }
+
+  public:
+    /**
+     * @brief Renders a triangle from a script line without prompting
+     * @param args Reader positioned after the command word: "<right|inverted|both> <height>"
+     * @param out Receives the rows; "both" separates the shapes with a blank line
+     * @return false (with the reason in args.error()) if the shape or height is invalid
+     *
+     * The shape may also be given as its menu number (1-3). Heights are
+     * limited to MIN_HEIGHT..MAX_HEIGHT like the menu; use --triangle for more.
+     */
+    bool renderCommand(FieldReader& args, OutputWriter& out) const {
+      string_view shape;
+      int height;
+      if (!args.nextField(shape, "triangle shape")) return false;
+
+      bool right = shape == "right" || shape == "1";
+      bool inverted = shape == "inverted" || shape == "2";
+      if (shape == "both" || shape == "3") right = inverted = true;
+      if (!right && !inverted) return args.rejectField("triangle shape must be right, inverted or both");
+
+      if (!args.nextInt<MIN_HEIGHT, MAX_HEIGHT>(height, "height") || !args.expectLineEnd()) return false;
+
+      if (right) displayRightTriangle(out, menuRows, height);
+      if (right && inverted) out.put('\n');
+      if (inverted) displayInvertedTriangle(out, menuRows, height);
+      return true;
+    }
+
+    /**
+     * @brief Runs the Triangle Loop Activity
+     * 
+     * Provides a menu for users to choose triangle type,
+     * specify height, and view the generated patterns.
+     */
+    Task<> runTriangleActivity(Session& session) const {
+      // constant value of min and max value to required to pass
+      const int MIN_MENU_OPTION = 1;
+      const int MAX_MENU_OPTION = 4;
+
+      UI::header(session.out, "Triangle Loop Activity");
+      int menuChoice, height;
+
+      // Main activity loop
+      while (true) {
+        session.out << "Triangle Options:\n"
+                    << "1. Right Triangle\n"
+                    << "2. Inverted Triangle\n"
+                    << "3. Both\n"
+                    << "4. Exit\n";
+        UI::line(session.out);
+
+        // Get user's triangle choice
+        menuChoice = co_await InputValidator::getValidatedChoice<MIN_MENU_OPTION, MAX_MENU_OPTION>(session, "Enter choice (1-4): ");
+
+        // Exit Triangle Activity
+        if (menuChoice == 4) {
+          UI::goodbyeMessage(session.out, "Exiting Triangle Activity...\n");
+          UI::goodbyeMessage(session.out, "Successfully Navigated to Main Menu\n\n");
+          break;
+        }
+
+        // Get triangle height (limited to 1-20 for display purposes)
+        height = co_await InputValidator::getValidatedChoice<MIN_HEIGHT, MAX_HEIGHT>(session, "Enter height (1-20): ");
+
+        session.out << "\n";
+        switch (menuChoice) {
+          case 1:
+            session.out << "Right Triangle:\n";
+            displayRightTriangle(session.out, height);
+            co_await UI::pauseBuffer(session);
+            break;
+          case 2:
+            session.out << "Inverted Triangle:\n";
+            displayInvertedTriangle(session.out, height);
+            co_await UI::pauseBuffer(session);
+            break;
+          case 3:
+            session.out << "Right Triangle:\n";
+            displayRightTriangle(session.out, height);
+            session.out << "\nInverted Triangle:\n";
+            displayInvertedTriangle(session.out, height);
+            co_await UI::pauseBuffer(session);
+            break;
+          default:
+            session.out << "[ERROR] Choice must be 1-4. Try again.";
+        }
+        session.out << "\n";
+      }
+    }
+};
+
+// ================================================== CURRENCY TABLE CLASS ================================================
+/**
+ * @struct CurrencyRate
+ * @brief One row of the currency table
+ *
+ * Rows are fixed-size and stored back to back, so conversions and
+ * displays walk a single contiguous array.
+ */
+struct CurrencyRate {
+  char code[4];       // ISO 4217 code, NUL-terminated (e.g. "USD")
+  char symbol[12];    // UTF-8 display symbol, NUL-terminated (e.g. "€")
+  double rate;        // PHP per one unit of the currency
+  double perPHP;      // Units of the currency per PHP (1 / rate)
+  int64_t rateFixed;  // rate as an exact fixed-point value with CurrencyTable::RATE_DECIMALS decimals
+};
+
+/**
+ * @class CurrencyTable
+ * @brief Flat table of the currencies PHP can be converted to
+ *
+ * Starts with the built-in USD, EUR, JPY and AUD rates and can be
+ * replaced at startup from a "CODE,SYMBOL,RATE" file.
+ */
+class CurrencyTable {
+  public:
+    static constexpr size_t MAX_SYMBOL_BYTES = sizeof(CurrencyRate::symbol) - 1;
+    static constexpr int RATE_DECIMALS = 8;                 // Fixed-point rates are kept in units of 1e-8 PHP
+
+    // @brief Returns the built-in rates.
+    static CurrencyTable defaults() {
+      CurrencyTable table;
+      table.add("USD", "$", "58.2554");   // 1 USD = ₱58.2554
+      table.add("EUR", "€", "67.6375");   // 1 EUR = ₱67.6375
+      table.add("JPY", "¥", "0.3818");    // 1 JPY = ₱0.3818
+      table.add("AUD", "A$", "38.3071");  // 1 AUD = ₱38.3071
+      return table;
+    }
+
+    /**
+     * @brief Replaces the table with the rows of a rate file
+     * @param text File contents, one "CODE,SYMBOL,RATE" line per currency
+     * @param errors Receives the line, column and reason of each rejected line
+     * @return true if at least one valid row was loaded and none were rejected
+     *
+     * Each code may appear once, and PHP may not appear at all since it
+     * is the base every rate is quoted against.
+     *
+     * RATE is PHP per one unit of the currency and is read exactly to
+     * RATE_DECIMALS decimals (further digits round half-even), so the
+     * double and fixed-point conversions share one source value. Blank lines and an
+     * optional "Code" header line are skipped. On failure the current
+     * table is left unchanged.
+     */
+    bool load(string_view text, vector<ParseError>& errors) {
+      CurrencyTable loaded;
+      size_t errorCount = errors.size();
+
+      FieldReader reader(text);
+      while (reader.nextLine()) {
+        if (reader.isBlankLine()) continue;
+        if (reader.currentLineNumber() == 1 && FieldReader::isHeaderLine(reader.line(), "Code")) continue;
+
+        string_view code, symbol;
+        int64_t rate;
+        bool valid = reader.nextField(code, "currency code")
+                  && (isCurrencyCode(code) || reader.rejectField("currency code must be 3 capital letters"))
+                  && (code != "PHP" || reader.rejectField("PHP is the base currency and cannot be listed"))
+                  && (!loaded.contains(code) || reader.rejectField("currency code " + string(code) + " is listed twice"))
+                  && reader.nextField(symbol, "currency symbol")
+                  && ((!symbol.empty() && symbol.size() <= MAX_SYMBOL_BYTES)
+                      || reader.rejectField("currency symbol must be 1-" + to_string(MAX_SYMBOL_BYTES) + " bytes"))
+                  && reader.nextFixed(rate, RATE_DECIMALS, RoundingMode::HalfEven, 0, MAX_RATE, "rate")
+                  && (rate > 0 || reader.rejectField("rate must be greater than 0"))
+                  && reader.expectLineEnd();
+
+        if (!valid) {
+          errors.push_back(reader.error());
+          continue;
+        }
+        loaded.add(code, symbol, rate);
+      }
+
+      if (errors.size() != errorCount || loaded.rows.empty()) return false;
+      rows.swap(loaded.rows);
+      return true;
+    }
+
+    // @brief Returns the number of currencies.
+    size_t size() const { return rows.size(); }
+
+    const CurrencyRate& operator[](size_t index) const { return rows[index]; }
+    const CurrencyRate* begin() const { return rows.data(); }
+    const CurrencyRate* end() const { return rows.data() + rows.size(); }
+
+    /**
+     * @brief Appends a display label such as "EUR (€)" padded to a column width
+     * @param out The formatter to append to
+     * @param row The currency
+     * @param width Target width in terminal columns (UTF-8 aware)
+     */
+    static void appendLabel(TextFormatter& out, const CurrencyRate& row, size_t width) {
+      size_t start = out.mark();
+      out.text(row.code).text(" (").text(row.symbol).text(")").padColumnsTo(start, width);
+    }
+
+  private:
+    static constexpr int64_t MAX_RATE = 1000000000;         // Keeps amount * 10^RATE_DECIMALS within int64
+
+    vector<CurrencyRate> rows;
+
+    // Adds a row from an exact fixed-point rate; the double rate is its nearest value
+    void add(string_view code, string_view symbol, int64_t rateFixed) {
+      CurrencyRate row = {};
+      memcpy(row.code, code.data(), min(code.size(), sizeof(row.code) - 1));
+      memcpy(row.symbol, symbol.data(), min(symbol.size(), sizeof(row.symbol) - 1));
+      row.rateFixed = rateFixed;
+      row.rate = static_cast<double>(rateFixed) / static_cast<double>(FixedPoint::scale(RATE_DECIMALS));
+      row.perPHP = 1.0 / row.rate;
+      rows.push_back(row);
+    }
+
+    void add(string_view code, string_view symbol, string_view rate) {
+      int64_t rateFixed = 0;
+      FixedPoint::parse(rate, RATE_DECIMALS, RoundingMode::HalfEven, rateFixed);
+      add(code, symbol, rateFixed);
+    }
+
+    bool contains(string_view code) const {
+      return any_of(rows.begin(), rows.end(), [&](const CurrencyRate& row) { return code == row.code; });
+    }
+
+    static bool isCurrencyCode(string_view code) {
+      if (code.size() != 3) return false;
+      for (char c : code) {
+        if (c < 'A' || c > 'Z') return false;
+      }
+      return true;
+    }
+};
+
+// ================================================== RATE MATRIX CLASS ================================================
+/**
+ * @class RateMatrix
+ * @brief Dense any-to-any exchange rates of one CurrencyTable
+ *
+ * Index PHP is the peso; index c + 1 is row c of the table. Cell
+ * (from, to) holds units of `to` per unit of `from`, so a cross
+ * conversion is one load and one multiply with no path search. The
+ * table only quotes currencies against PHP, so every cross rate is the
+ * single hop rate[from] / rate[to] through PHP, divided once here
+ * rather than per request.
+ *
+ * Rows are padded to whole cache lines and start on one, so a
+ * conversion out of one currency touches only that row. Currency codes
+ * map to indexes through a direct 26^3 table of every 3-letter code.
+ */
+class RateMatrix {
+  public:
+    static constexpr size_t PHP = 0;                         // Index of the base currency
+    static constexpr size_t NOT_FOUND = SIZE_MAX;            // indexOf() result for unknown codes
+
+    explicit RateMatrix(const CurrencyTable& table)
+        : count(table.size() + 1),
+          stride((count + DOUBLES_PER_LINE - 1) / DOUBLES_PER_LINE * DOUBLES_PER_LINE),
+          cells(static_cast<double*>(::operator new(count * stride * sizeof(double), align_val_t{CACHE_LINE}))),
+          codeIndex(new uint32_t[CODE_SLOTS]()) {
+      // PHP per unit of each index; the peso is worth itself
+      vector<double> phpPerUnit(count, 1.0);
+      for (size_t c = 0; c < table.size(); c++) phpPerUnit[c + 1] = table[c].rate;
+
+      for (size_t from = 0; from < count; from++) {
+        double* row = cells.get() + from * stride;
+        for (size_t to = 0; to < count; to++) row[to] = phpPerUnit[from] / phpPerUnit[to];
+        fill(row + count, row + stride, 0.0);
+      }
+
+      codeIndex[slotOf("PHP")] = PHP + 1;
+      for (size_t c = 0; c < table.size(); c++) codeIndex[slotOf(table[c].code)] = static_cast<uint32_t>(c + 2);
+    }
+
+    // @brief Returns the number of currencies, PHP included.
+    size_t size() const { return count; }
+
+    // @brief Returns the index of a 3-letter code, or NOT_FOUND.
+    size_t indexOf(string_view code) const {
+      if (code.size() != 3) return NOT_FOUND;
+      for (char c : code) {
+        if (c < 'A' || c > 'Z') return NOT_FOUND;
+      }
+      return static_cast<size_t>(codeIndex[slotOf(code)]) - 1;   // 0 (unused slot) wraps to NOT_FOUND
+    }
+
+    // @brief Returns units of `to` per unit of `from`.
+    double rate(size_t from, size_t to) const { return cells[from * stride + to]; }
+
+    // @brief Returns the rates out of `from`, indexed like rate().
+    const double* row(size_t from) const { return cells.get() + from * stride; }
+
+    // @brief Converts amount units of `from` into `to`.
+    double convert(double amount, size_t from, size_t to) const { return amount * rate(from, to); }
+
+  private:
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr size_t DOUBLES_PER_LINE = CACHE_LINE / sizeof(double);
+    static constexpr size_t CODE_SLOTS = 26 * 26 * 26;
+
+    struct AlignedDelete {
+      void operator()(double* cells) const { ::operator delete(cells, align_val_t{CACHE_LINE}); }
+    };
+
+    size_t count;                                 // Currencies, PHP included
+    size_t stride;                                // Doubles per row, a whole number of cache lines
+    unique_ptr<double[], AlignedDelete> cells;    // count rows of stride doubles
+    unique_ptr<uint32_t[]> codeIndex;             // index + 1 per code slot, 0 if unused
+
+    static size_t slotOf(string_view code) {
+      return static_cast<size_t>(code[0] - 'A') * 26 * 26 + static_cast<size_t>(code[1] - 'A') * 26 + static_cast<size_t>(code[2] - 'A');
+    }
+};
+
+// ================================================== RATE SNAPSHOT CLASSES ================================================
+/**
+ * @struct RateSnapshot
+ * @brief An immutable, versioned copy of the currency table
+ *
+ * The cross-rate matrix is computed once, when the snapshot is built,
+ * and shared by every reader of that version.
+ */
+struct RateSnapshot {
+  uint64_t version;       // 1 for the startup table, +1 for every publish
+  CurrencyTable table;
+  RateMatrix matrix;      // Any-to-any rates of table
+
+  RateSnapshot(uint64_t version, CurrencyTable currencies) : version(version), table(move(currencies)), matrix(table) {}
+};
+
+// One per reading thread; epoch is 0 while the thread holds no ReadGuard
+struct alignas(64) RateReaderSlot {
+  atomic<uint64_t> epoch{0};
+  atomic<bool> claimed{false};
+};
+
+// A fixed run of reader slots; blocks are chained on as more threads read and never freed
+struct RateReaderBlock {
+  static constexpr size_t SLOTS = 256;
+  RateReaderSlot slots[SLOTS];
+  atomic<RateReaderBlock*> next{nullptr};
+};
+
+// A thread's claim on a RateReaderSlot, released when the thread exits
+struct RateReaderThread {
+  RateReaderSlot* slot = nullptr;
+  unsigned depth = 0;     // Nested guards on this thread
+  ~RateReaderThread() {
+    if (slot != nullptr) slot->claimed.store(false);
+  }
+};
+
+/**
+ * @class RateSnapshotPublisher
+ * @brief Publishes rate snapshots to lock-free readers (RCU style)
+ *
+ * Readers pin the current snapshot with a ReadGuard, which costs two
+ * atomic stores and a load and never blocks. A writer swaps in a new
+ * snapshot with publish() without waiting for in-flight conversions; the
+ * old snapshot is freed on a later publish, once no reader that could
+ * have seen it is still inside a guard (epoch-based reclamation).
+ *
+ * A thread claims a reader slot on its first guard and frees it on exit.
+ * Slots come in blocks of RateReaderBlock::SLOTS that are chained on as
+ * needed, so any number of threads can read at once.
+ */
+class RateSnapshotPublisher {
+  private:
+    // Shared by every publisher: epochs only need to be ordered, not per table
+    static inline RateReaderBlock slots;
+    static inline atomic<uint64_t> globalEpoch{1};
+    static inline thread_local RateReaderThread threadSlot;
+
+    // Claims a free slot, chaining on a new block when every slot is taken
+    static RateReaderSlot* claimSlot() {
+      RateReaderBlock* block = &slots;
+      while (true) {
+        for (RateReaderSlot& candidate : block->slots) {
+          bool expected = false;
+          if (candidate.claimed.compare_exchange_strong(expected, true)) return &candidate;
+        }
+
+        RateReaderBlock* next = block->next.load();
+        if (next == nullptr) {
+          auto added = make_unique<RateReaderBlock>();
+          added->slots[0].claimed.store(true);
+          if (block->next.compare_exchange_strong(next, added.get())) return &added.release()->slots[0];
+          // Another thread chained a block first; next now points at it
+        }
+        block = next;
+      }
+    }
+
+    static void enterReadSection() {
+      RateReaderThread& self = threadSlot;
+      if (self.slot == nullptr) self.slot = claimSlot();
+      if (self.depth++ == 0) self.slot->epoch.store(globalEpoch.load());
+    }
+
+    static void leaveReadSection() {
+      RateReaderThread& self = threadSlot;
+      if (--self.depth == 0) self.slot->epoch.store(0);
+    }
+
+  public:
+    /**
+     * @class ReadGuard
+     * @brief Keeps one snapshot alive while it is in scope
+     */
+    class ReadGuard {
+      public:
+        explicit ReadGuard(const RateSnapshotPublisher& publisher) {
+          enterReadSection();
+          snapshot = publisher.current.load();
+        }
+        ~ReadGuard() { leaveReadSection(); }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const RateSnapshot& operator*() const { return *snapshot; }
+        const RateSnapshot* operator->() const { return snapshot; }
+
+      private:
+        const RateSnapshot* snapshot;
+    };
+
+    explicit RateSnapshotPublisher(CurrencyTable table) : current(new RateSnapshot{1, move(table)}) {}
+
+    RateSnapshotPublisher(const RateSnapshotPublisher&) = delete;
+    RateSnapshotPublisher& operator=(const RateSnapshotPublisher&) = delete;
+
+    // @brief Frees every snapshot; no ReadGuard may outlive the publisher.
+    ~RateSnapshotPublisher() {
+      delete current.load();
+      for (const auto& [snapshot, epoch] : retired) delete snapshot;
+    }
+
+    // @brief Pins and returns the current snapshot.
+    ReadGuard read() const { return ReadGuard(*this); }
+
+    /**
+     * @brief Makes a new table visible to all subsequent readers
+     * @param table The replacement rates
+     * @return The version number of the new snapshot
+     */
+    uint64_t publish(CurrencyTable table) {
+      lock_guard<mutex> guard(writerLock);
+
+      const RateSnapshot* previous = current.load();
+      const RateSnapshot* next = new RateSnapshot{previous->version + 1, move(table)};
+      current.store(next);
+
+      // Readers that announce a later epoch are guaranteed to see next
+      retired.emplace_back(previous, globalEpoch.fetch_add(1));
+      reclaim();
+      return next->version;
+    }
+
+    // @brief Returns the version readers currently get.
+    uint64_t version() const { return current.load()->version; }
+
+  private:
+    atomic<const RateSnapshot*> current;
+    mutex writerLock;                                         // Serializes publishers only
+    vector<pair<const RateSnapshot*, uint64_t>> retired;      // (snapshot, epoch it was retired in)
+
+    // Frees retired snapshots that no active reader can still hold
+    void reclaim() {
+      uint64_t oldestActive = numeric_limits<uint64_t>::max();
+      for (const RateReaderBlock* block = &slots; block != nullptr; block = block->next.load()) {
+        for (const RateReaderSlot& slot : block->slots) {
+          uint64_t epoch = slot.epoch.load();
+          if (epoch != 0) oldestActive = min(oldestActive, epoch);
+        }
+      }
+
+      size_t kept = 0;
+      for (const auto& entry : retired) {
+        if (entry.second < oldestActive) {
+          delete entry.first;
+        } else {
+          retired[kept++] = entry;
+        }
+      }
+      retired.resize(kept);
+    }
+};
+
+/**
+ * @class RateFileWatcher
+ * @brief Republishes a rate file whenever it changes on disk
+ *
+ * Polls the file's modification time from a background thread. A file
+ * that fails to load is reported and the previous snapshot stays live.
+ */
+class RateFileWatcher {
+  public:
+    /**
+     * @brief Starts watching
+     * @param ratesPath The CODE,SYMBOL,RATE file to watch
+     * @param publisher Where reloaded tables are published
+     * @param interval Time between checks
+     */
+    RateFileWatcher(string ratesPath, RateSnapshotPublisher& publisher, chrono::milliseconds interval = chrono::seconds(1))
+      : path(move(ratesPath)), target(publisher), pollInterval(interval), lastModified(modificationTime()) {
+      watcher = thread([this]() { watch(); });
+    }
+
+    ~RateFileWatcher() {
+      {
+        lock_guard<mutex> guard(stopLock);
+        stopping = true;
+      }
+      stopSignal.notify_all();
+      watcher.join();
+    }
+
+  private:
+    string path;
+    RateSnapshotPublisher& target;
+    chrono::milliseconds pollInterval;
+    long long lastModified;
+
+    mutex stopLock;
+    condition_variable stopSignal;
+    bool stopping = false;
+    thread watcher;
+
+    long long modificationTime() const {
+#if defined(__unix__) || defined(__APPLE__)
+      struct stat info;
+      if (stat(path.c_str(), &info) != 0) return 0;
+#if defined(__APPLE__)
+      return static_cast<long long>(info.st_mtime) * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+      return static_cast<long long>(info.st_mtime) * 1000000000LL + info.st_mtim.tv_nsec;
+#endif
+#else
+      return 0;
+#endif
+    }
+
+    void watch() {
+      unique_lock<mutex> guard(stopLock);
+      while (!stopSignal.wait_for(guard, pollInterval, [this]() { return stopping; })) {
+        long long modified = modificationTime();
+        if (modified == 0 || modified == lastModified) continue;
+        lastModified = modified;
+
+        MappedFile file;
+        CurrencyTable table;
+        vector<ParseError> errors;
+        if (file.open(path) && table.load(file.text(), errors)) {
+          uint64_t version = target.publish(move(table));
+          cerr << "[INFO] Reloaded exchange rates from " << path << " (version " << version << ")\n";
+        } else {
+          cerr << "[ERROR] Ignoring invalid rate file " << path << "; keeping version " << target.version() << "\n";
+        }
+      }
+    }
+};
+
+// ================================================== CONVERSION CACHE CLASS ================================================
+/**
+ * @class ConversionCache
+ * @brief Bounded, sharded cache of formatted conversion results
+ *
+ * Most conversions are for a few round amounts, so the formatted result
+ * of each (amount, view) pair is kept for the rate snapshot it was
+ * computed with. Amounts hash to one of SHARD_COUNT independently locked
+ * shards, each holding ENTRIES_PER_SHARD entries replaced in CLOCK
+ * order: a hit sets an entry's reference bit, and the hand clears bits
+ * until it finds an unreferenced entry to reuse.
+ *
+ * Entries are keyed by snapshot version. The first lookup with a newer
+ * version empties the shard, so a rate change invalidates everything
+ * without a separate notification. Lookups with an older version (a
+ * reader still pinning the previous snapshot) always miss.
+ */
+class ConversionCache {
+  public:
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t ENTRIES_PER_SHARD = 64;
+
+    // @brief Which rendering of a conversion an entry holds.
+    enum class View : uint8_t { Table, Csv };
+
+    /**
+     * @brief Appends the cached text of a conversion to out
+     * @return false on a miss, leaving out unchanged
+     */
+    bool find(uint64_t version, double amount, View view, TextFormatter& out) {
+      const uint64_t key = bit_cast<uint64_t>(amount);
+      Shard& shard = shardOf(key);
+      lock_guard<mutex> guard(shard.lock);
+      if (version > shard.version) shard.invalidate(version);
+
+      if (version == shard.version) {
+        for (Entry& entry : shard.entries) {
+          if (!entry.used || entry.amountBits != key || entry.view != view) continue;
+          entry.referenced = true;
+          out.text(entry.text);
+          shard.hits++;
+          Metrics::count(Counter::ConversionCacheHits);
+          return true;
+        }
+      }
+      shard.misses++;
+      Metrics::count(Counter::ConversionCacheMisses);
+      return false;
+    }
+
+    // @brief Stores the text of a conversion computed with the given snapshot version.
+    void insert(uint64_t version, double amount, View view, string_view text) {
+      const uint64_t key = bit_cast<uint64_t>(amount);
+      Shard& shard = shardOf(key);
+      lock_guard<mutex> guard(shard.lock);
+      if (version > shard.version) shard.invalidate(version);
+      if (version != shard.version) return;   // Computed with rates that have since been replaced
+
+      for (Entry& entry : shard.entries) {
+        if (entry.used && entry.amountBits == key && entry.view == view) return;   // Inserted meanwhile by another thread
+      }
+
+      // CLOCK: skip (and clear) referenced entries until an unreferenced one comes up
+      while (shard.entries[shard.hand].used && shard.entries[shard.hand].referenced) {
+        shard.entries[shard.hand].referenced = false;
+        shard.hand = (shard.hand + 1) % ENTRIES_PER_SHARD;
+      }
+      Entry& entry = shard.entries[shard.hand];
+      shard.hand = (shard.hand + 1) % ENTRIES_PER_SHARD;
+      entry.used = true;
+      entry.referenced = false;
+      entry.amountBits = key;
+      entry.view = view;
+      entry.text.assign(text.data(), text.size());   // Reuses the evicted entry's capacity
+    }
+
+    /**
+     * @struct Statistics
+     * @brief Lookups answered from the cache so far
+     */
+    struct Statistics {
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+
+      double hitRatio() const { return hits + misses > 0 ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0; }
+    };
+
+    Statistics statistics() const {
+      Statistics total;
+      for (const Shard& shard : shards) {
+        lock_guard<mutex> guard(shard.lock);
+        total.hits += shard.hits;
+        total.misses += shard.misses;
+      }
+      return total;
+    }
+
+  private:
+    struct Entry {
+      uint64_t amountBits = 0;
+      View view = View::Table;
+      bool used = false;
+      bool referenced = false;
+      string text;
+    };
+
+    struct alignas(64) Shard {
+      mutable mutex lock;
+      uint64_t version = 0;   // Snapshot version of every used entry
+      size_t hand = 0;        // CLOCK position
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+      Entry entries[ENTRIES_PER_SHARD];
+
+      void invalidate(uint64_t newVersion) {
+        for (Entry& entry : entries) entry.used = false;
+        version = newVersion;
+        hand = 0;
+      }
+    };
+
+    Shard shards[SHARD_COUNT];
+
+    Shard& shardOf(uint64_t key) {
+      key ^= key >> 33;   // Round amounts differ mostly in their high bits
+      key *= 0xff51afd7ed558ccdULL;
+      key ^= key >> 33;
+      return shards[key % SHARD_COUNT];
+    }
+};
+
+// ================================================== CURRENCY CALCULATOR ================================================
+/**
+ * @class CurrencyCalculator
+ * @brief Converts Philippine Pesos to multiple foreign currencies
+ * 
+ * This class handles currency conversion with real-time rates,
+ * applies transaction fees, and displays comprehensive results.
+ * The supported currencies come from a CurrencyTable that is published
+ * as RateSnapshots, so rates can be replaced while conversions run.
+ */
+class CurrencyCalculator {
+  public:
+    static constexpr int MIN_AMOUNT = 100;        // Smallest PHP amount accepted per transaction
+    static constexpr int MAX_AMMOUNT = 100000;    // Largest PHP amount accepted per transaction
+    static constexpr double MAX_CROSS_AMOUNT = 1e12;     // Largest amount of any currency accepted by "cross"
+
+    /**
+     * @struct ConversionResult
+     * @brief Fee, net amount and per-currency values of one conversion
+     */
+    struct ConversionResult {
+      double amountInPHP;         // Original PHP amount before fees
+      double fee;                 // Transaction fee deducted
+      double netPHP;              // Net PHP amount after fee deduction
+      pmr::vector<double> converted;   // Net amount in each currency, in snapshot table order
+      uint64_t rateVersion;       // Version of the RateSnapshot used
+    };
+
+    /**
+     * @brief Creates a calculator for the given currencies
+     * @param currencyTable Rates to convert with (the built-in four by default)
+     */
+    explicit CurrencyCalculator(CurrencyTable currencyTable = CurrencyTable::defaults()) : rates(move(currencyTable)) {}
+
+    // @brief Pins the current exchange rates for a batch of conversions.
+    RateSnapshotPublisher::ReadGuard currentRates() const { return rates.read(); }
+
+    // @brief Returns the publisher that hot-reloads replace rates through.
+    RateSnapshotPublisher& rateSnapshots() { return rates; }
+
+    /**
+     * @brief Converts one PHP amount with the given snapshot
+     * @param amountInPHP Amount already validated against MIN_AMOUNT..MAX_AMMOUNT
+     * @param snapshot Rates to use (typically from currentRates())
+     * @param memory Where the converted values live (e.g. a session's Arena)
+     *
+     * Callers count Counter::Conversions themselves, since a ConversionCache
+     * hit answers a conversion without calling this.
+     */
+    ConversionResult convert(double amountInPHP, const RateSnapshot& snapshot,
+                             pmr::memory_resource* memory = pmr::get_default_resource()) const {
+      Metrics::ScopedTimer timer(Timer::Conversion);
+      ConversionResult result{amountInPHP, 0, 0, pmr::vector<double>(snapshot.table.size(), memory), 0};
+      result.fee = amountInPHP * TRANSACTION_FEE_RATE;
+      result.netPHP = amountInPHP - result.fee;
+      for (size_t c = 0; c < snapshot.table.size(); c++) result.converted[c] = result.netPHP / snapshot.table[c].rate;
+      result.rateVersion = snapshot.version;
+      return result;
+    }
+
+    /**
+     * @brief Parses a transaction file with one PHP amount per line
+     * @param text File contents, e.g. from a MappedFile
+     * @param amounts Receives every valid amount, in file order
+     * @param errors Receives the line, column and reason of each rejected line
+     *
+     * Applies the same MIN_AMOUNT..MAX_AMMOUNT bounds as the interactive
+     * prompt. Blank lines and an optional "Amount" header line are skipped.
+     * The bounds are checked in bulk on every block of parsed amounts;
+     * rejected lines are re-read one by one to report their first error.
+     */
+    static void parseAmounts(string_view text, vector<double>& amounts, vector<ParseError>& errors) {
+      const size_t BLOCK_SIZE = 8192;   // Amounts range-checked per validateColumn() call
+      vector<string_view> blockLines;   // Source line of each unchecked amount
+      vector<size_t> blockLineNumbers;
+      vector<uint64_t> validBits((BLOCK_SIZE + 63) / 64);
+      size_t checked = amounts.size();
+      const size_t firstError = errors.size();
+
+      // Re-reads a rejected line with the interactive bounds and records its first error
+      auto reject = [&](string_view line, size_t lineNumber) {
+        FieldReader strict(line);
+        strict.nextLine();
+        double amount;
+        if (strict.nextDouble<MIN_AMOUNT, MAX_AMMOUNT>(amount, "amount")) strict.expectLineEnd();
+        errors.push_back(strict.error());
+        errors.back().line = lineNumber;
+      };
+
+      // Range-checks the amounts parsed since the last call and drops the rejected ones
+      auto checkBlock = [&]() {
+        span<const double> block(amounts.data() + checked, amounts.size() - checked);
+        if (InputValidator::validateColumn<MIN_AMOUNT, MAX_AMMOUNT>(block, validBits.data()) > 0) {
+          size_t kept = checked;
+          for (size_t i = 0; i < block.size(); i++) {
+            if ((validBits[i / 64] >> (i % 64)) & 1) amounts[kept++] = block[i];
+            else reject(blockLines[i], blockLineNumbers[i]);
+          }
+          amounts.resize(kept);
+        }
+        checked = amounts.size();
+        blockLines.clear();
+        blockLineNumbers.clear();
+      };
+
+      FieldReader reader(text);
+      while (reader.nextLine()) {
+        if (reader.isBlankLine()) continue;
+
+        if (reader.currentLineNumber() == 1 && FieldReader::isHeaderLine(reader.line(), "Amount")) continue;
+
+        string_view line = reader.line();
+        double amount;
+        if (reader.nextNumber(amount, "amount") && reader.expectLineEnd()) {
+          amounts.push_back(amount);
+          blockLines.push_back(line);
+          blockLineNumbers.push_back(reader.currentLineNumber());
+          if (blockLines.size() == BLOCK_SIZE) checkBlock();
+        } else {
+          reject(line, reader.currentLineNumber());
+        }
+      }
+      checkBlock();
+
+      stable_sort(errors.begin() + static_cast<ptrdiff_t>(firstError), errors.end(),
+                  [](const ParseError& a, const ParseError& b) { return a.line < b.line; });
+    }
+
+    /**
+     * @struct ConversionColumns
+     * @brief Caller-owned output buffers for convertBatch()
+     *
+     * Every pointer must have room for as many values as there are
+     * input amounts. The buffers are written column by column.
+     */
+    struct ConversionColumns {
+      double* fee;                // Transaction fee in PHP
+      double* netPHP;             // PHP left after the fee
+      double* const* converted;   // converted[c] receives the net amount in snapshot table row c
+    };
+
+    /**
+     * @brief Converts many PHP amounts at once, without prompting
+     * @param amounts PHP amounts, already validated against MIN_AMOUNT..MAX_AMMOUNT
+     * @param out Buffers that receive the fee, net PHP and converted amounts
+     * @param snapshot Rates to use; out.converted must have one buffer per table row
+     * @return The version of the snapshot, to record alongside the results
+     *
+     * The fee and conversions are multiplies by TRANSACTION_FEE_RATE and
+     * the table's precomputed reciprocals, done with AVX2 (4 amounts per
+     * step) or NEON (2 per step) when available. Multiplying by a reciprocal
+     * may differ from convertCurrency()'s division in the last bit, which
+     * never shows at the two decimals the results are reported with.
+     */
+    uint64_t convertBatch(span<const double> amounts, const ConversionColumns& out, const RateSnapshot& snapshot) const {
+      Metrics::ScopedTimer timer(Timer::Conversion);
+      Metrics::count(Counter::Conversions, amounts.size());
+      const size_t count = amounts.size();
+      const double* php = amounts.data();
+      size_t i = 0;
+
+#if defined(__AVX2__)
+      const __m256d feeRate = _mm256_set1_pd(TRANSACTION_FEE_RATE);
+      for (; i + 4 <= count; i += 4) {
+        __m256d amount = _mm256_loadu_pd(php + i);
+        __m256d fee = _mm256_mul_pd(amount, feeRate);
+        _mm256_storeu_pd(out.fee + i, fee);
+        _mm256_storeu_pd(out.netPHP + i, _mm256_sub_pd(amount, fee));
+      }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+      const float64x2_t feeRate = vdupq_n_f64(TRANSACTION_FEE_RATE);
+      for (; i + 2 <= count; i += 2) {
+        float64x2_t amount = vld1q_f64(php + i);
+        float64x2_t fee = vmulq_f64(amount, feeRate);
+        vst1q_f64(out.fee + i, fee);
+        vst1q_f64(out.netPHP + i, vsubq_f64(amount, fee));
+      }
+#endif
+      for (; i < count; i++) {
+        out.fee[i] = php[i] * TRANSACTION_FEE_RATE;
+        out.netPHP[i] = php[i] - out.fee[i];
+      }
+
+      // One streaming pass over the net column per currency
+      for (size_t c = 0; c < snapshot.table.size(); c++) {
+        scaleColumn(out.netPHP, count, snapshot.table[c].perPHP, out.converted[c]);
+      }
+      return snapshot.version;
+    }
+
+    static constexpr int MONEY_DECIMALS = 2;  // Fixed-point amounts are in centavos / hundredths of a unit
+
+    /**
+     * @brief Parses a transaction file into exact centavo amounts
+     * @param text File contents, one PHP amount per line
+     * @param centavos Receives every valid amount in centavos, in file order
+     * @param errors Receives the line, column and reason of each rejected line
+     * @param mode Rounding for amounts given with more than two decimals
+     */
+    static void parseAmountsFixed(string_view text, vector<int64_t>& centavos, vector<ParseError>& errors, RoundingMode mode) {
+      FieldReader reader(text);
+      while (reader.nextLine()) {
+        if (reader.isBlankLine()) continue;
+        if (reader.currentLineNumber() == 1 && FieldReader::isHeaderLine(reader.line(), "Amount")) continue;
+
+        int64_t amount;
+        if (reader.nextFixed(amount, MONEY_DECIMALS, mode, MIN_AMOUNT, MAX_AMMOUNT, "amount") && reader.expectLineEnd()) {
+          centavos.push_back(amount);
+        } else {
+          errors.push_back(reader.error());
+        }
+      }
+    }
+
+    /**
+     * @struct FixedConversionColumns
+     * @brief Caller-owned output buffers for convertBatchFixed(), all in hundredths
+     */
+    struct FixedConversionColumns {
+      int64_t* fee;                 // Transaction fee in centavos
+      int64_t* netPHP;              // Centavos left after the fee
+      int64_t* const* converted;    // converted[c] receives hundredths of snapshot table row c
+    };
+
+    /**
+     * @brief Converts centavo amounts with integer arithmetic only
+     * @param centavos PHP amounts in centavos, validated against MIN_AMOUNT..MAX_AMMOUNT
+     * @param out Buffers that receive fee, net and converted values in hundredths
+     * @param snapshot Rates to use; out.converted must have one buffer per table row
+     * @param mode How the fee and every conversion are rounded to the hundredth
+     * @return The version of the snapshot, to record alongside the results
+     *
+     * fee = round(amount * 5%), net = amount - fee (so fee + net is always
+     * exactly the amount), converted = round(net / rate) using the table's
+     * exact fixed-point rates. Results are identical across platforms.
+     */
+    uint64_t convertBatchFixed(span<const int64_t> centavos, const FixedConversionColumns& out,
+                               const RateSnapshot& snapshot, RoundingMode mode) const {
+      Metrics::ScopedTimer timer(Timer::Conversion);
+      Metrics::count(Counter::Conversions, centavos.size());
+      const size_t count = centavos.size();
+      for (size_t i = 0; i < count; i++) {
+        out.fee[i] = FixedPoint::divide(centavos[i] * TRANSACTION_FEE_BASIS_POINTS, 10000, mode);
+        out.netPHP[i] = centavos[i] - out.fee[i];
+      }
+
+      const int64_t rateUnit = FixedPoint::scale(CurrencyTable::RATE_DECIMALS);
+      for (size_t c = 0; c < snapshot.table.size(); c++) {
+        const int64_t rate = snapshot.table[c].rateFixed;
+        int64_t* target = out.converted[c];
+        for (size_t i = 0; i < count; i++) target[i] = FixedPoint::divide(out.netPHP[i] * rateUnit, rate, mode);
+      }
+      return snapshot.version;
+    }
+
+  private:
+    RateSnapshotPublisher rates;              // Exchange rates (PHP per unit of each currency)
+    mutable ConversionCache cache;            // Formatted results of recent amounts, per rate snapshot
+    const double TRANSACTION_FEE_RATE = 0.05; // 5% transaction fee
+    const int64_t TRANSACTION_FEE_BASIS_POINTS = 500;  // The same 5%, for fixed-point conversion
+
+    // Writes source[i] * factor to target[i] for every i
+    static void scaleColumn(const double* source, size_t count, double factor, double* target) {
+      size_t i = 0;
+#if defined(__AVX2__)
+      const __m256d scale = _mm256_set1_pd(factor);
+      for (; i + 4 <= count; i += 4) _mm256_storeu_pd(target + i, _mm256_mul_pd(_mm256_loadu_pd(source + i), scale));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+      const float64x2_t scale = vdupq_n_f64(factor);
+      for (; i + 2 <= count; i += 2) vst1q_f64(target + i, vmulq_f64(vld1q_f64(source + i), scale));
+#endif
+      for (; i < count; i++) target[i] = source[i] * factor;
+    }
+
+    /**
+     * @brief Displays current exchange rates and transaction policies
+     * @param out The session output to write to
+     */
+    void displayRates(ostream& out) const {
+      Metrics::ScopedTimer timer(Timer::DisplayRates);
+      Metrics::count(Counter::RateDisplays);
+      thread_local TextFormatter text;
+
+      UI::header(out, "Today's Exchange Rates");
+      UI::line(out);
+
+      // Display conversion rates from PHP to foreign currencies
+      RateSnapshotPublisher::ReadGuard snapshot = currentRates();
+      const double* perPHP = snapshot->matrix.row(RateMatrix::PHP);
+      for (size_t c = 0; c < snapshot->table.size(); c++) {
+        const CurrencyRate& currency = snapshot->table[c];
+        CurrencyTable::appendLabel(text, currency, 10);
+        text.text(": 1 PHP = ").fixed(perPHP[c + 1], 4).text(" ").text(currency.code).text("\n");
+      }
+      text.writeTo(out);
+
+      UI::line(out);
+      text.text("Transaction Fee: ").fixed(TRANSACTION_FEE_RATE * 100, 0).text("%\n")
+          .text("Minimum Transaction: ").text(TextFormatter::PESO_SIGN).text("100\n")
+          .text("Maximum Transaction: ").text(TextFormatter::PESO_SIGN).text("100,000\n");
+      text.writeTo(out);
+      UI::line(out);
+
+      // Leave the stream formatted as the iostream version did
+      out << fixed << setprecision(0);
+    }
+
+    /**
+     * @brief Displays formatted conversion results
+     * @param out The session output to write to
+     * @param amountInPHP Amount already validated against MIN_AMOUNT..MAX_AMMOUNT
+     * @param snapshot Rates to convert with
+     *
+     * The screen comes from the ConversionCache when the amount was shown
+     * before with the same rates; otherwise it is computed, formatted and cached.
+     * A computed result lives in an Arena of this call, so repeated
+     * conversions in the currency menu never pile up in the session's arena.
+     */
+    void displayConversion(ostream& out, double amountInPHP, const RateSnapshot& snapshot) const {
+      Metrics::ScopedTimer timer(Timer::DisplayConversion);
+      Metrics::count(Counter::Conversions);   // Hit or miss; the cache counters give the split
+      thread_local TextFormatter text;
+
+      if (!cache.find(snapshot.version, amountInPHP, ConversionCache::View::Table, text)) {
+        Arena scratch;   // Holds the converted values for this conversion only
+        formatConversion(text, convert(amountInPHP, snapshot, scratch.resource()), snapshot.table);
+        cache.insert(snapshot.version, amountInPHP, ConversionCache::View::Table, text.view());
+      }
+      text.writeTo(out);
+
+      // Leave the stream formatted as the iostream version did
+      out << fixed << setprecision(2) << (snapshot.table.size() > 0 ? left : right);
+    }
+
+    // Appends the whole "Conversion Result" screen of result
+    static void formatConversion(TextFormatter& text, const ConversionResult& result, const CurrencyTable& currencies) {
+      UI::header(text, "Conversion Result");
+      UI::line(text);
+      
+      // Display transaction summary
+      const size_t SUMMARY_WIDTH = 18;  // Summary label width
+      text.left("Original Amount", SUMMARY_WIDTH).text(": ").text(TextFormatter::PESO_SIGN).fixed(result.amountInPHP, 2).text("\n")
+          .left("Transaction Fee", SUMMARY_WIDTH).text(": ").text(TextFormatter::PESO_SIGN).fixed(result.fee, 2).text("\n")
+          .left("Net Amount", SUMMARY_WIDTH).text(": ").text(TextFormatter::PESO_SIGN).fixed(result.netPHP, 2).text("\n");
+
+      // Table column widths for aligned output
+      const size_t LABEL_WIDTH = 14;  // Currency label width
+      const size_t RATE_WIDTH  = 14;  // Exchange rate width
+      const size_t VALUE_WIDTH   = 12;  // Converted value width
+
+      UI::line(text);
+      // Table header
+      text.left("Currency", LABEL_WIDTH)
+          .left("Rate (PHP per ₱1)", RATE_WIDTH)
+          .right("Converted", VALUE_WIDTH).text("\n");
+
+      // Display each currency conversion
+      for (size_t c = 0; c < currencies.size(); c++) {
+        size_t column = text.mark();
+        CurrencyTable::appendLabel(text, currencies[c], LABEL_WIDTH);
+        text.padTo(column, LABEL_WIDTH);
+        column = text.mark();
+        text.fixed(currencies[c].rate, 2).text(" PHP").padTo(column, RATE_WIDTH)
+            .text("      ").fixed(result.converted[c], 2).text(" ").text(currencies[c].code).text("\n");
+      }
+    }
+
+    /**
+     * @brief Handles the currency conversion process
+     * 
+     * Guides user through amount input, fee confirmation,
+     * calculation, and result display.
+     */
+    Task<> convertCurrency(Session& session) const {
+      double amountInPHP;
+
+      // Get PHP amount with validation
+      amountInPHP = co_await InputValidator::getValidatedDouble<MIN_AMOUNT, MAX_AMMOUNT>(
+        session, "Enter amount in PHP (₱): "
+      );
+
+      // Confirm transaction with user
+      session.out << "A 5% transaction fee will be charged for the exchange.\n";
+      if (!co_await InputValidator::getValidatedYesNo(session, "Would you like to proceed?")) {
+        UI::goodbyeMessage(session.out, "Transaction cancelled.\n");
+        co_return;
+      }
+
+      // Calculate fee, net amount and all conversions with the live rates, and display them
+      RateSnapshotPublisher::ReadGuard snapshot = currentRates();
+      displayConversion(session.out, amountInPHP, *snapshot);
+    }
+
+  public:
+    /**
+     * @brief Runs one currency operation from a script line without prompting
+     * @param args Reader positioned after the command word: "convert <amount>", "cross <amount> <FROM> <TO>", "rates" or "cache"
+     * @param out Receives the result as CSV
+     * @return false (with the reason in args.error()) if the action or amount is invalid
+     *
+     * "convert" (or 1) skips the fee confirmation and writes
+     * "Amount,Fee,Net,<one column per currency>" values with two decimals,
+     * computed exactly like the menu's conversion. "cross" converts between
+     * any two currencies, PHP included, at the snapshot's RateMatrix rate
+     * with no fee, and writes FROM,TO,RATE,CONVERTED. "rates" (or 2) writes the
+     * live table as CODE,SYMBOL,RATE lines, the same layout --rates reads.
+     * "cache" writes the ConversionCache as hits,misses,hit ratio.
+     */
+    bool runCommand(FieldReader& args, OutputWriter& out) const {
+      string_view action;
+      if (!args.nextField(action, "currency action")) return false;
+
+      char number[32];
+      RateSnapshotPublisher::ReadGuard snapshot = currentRates();
+      if (action == "convert" || action == "1") {
+        double amountInPHP;
+        if (!args.nextDouble<MIN_AMOUNT, MAX_AMMOUNT>(amountInPHP, "amount") || !args.expectLineEnd()) return false;
+
+        Metrics::count(Counter::Conversions);
+        thread_local TextFormatter text;
+        if (!cache.find(snapshot->version, amountInPHP, ConversionCache::View::Csv, text)) {
+          Arena scratch;   // Holds the converted values for this command only
+          ConversionResult result = convert(amountInPHP, *snapshot, scratch.resource());
+          text.fixed(result.amountInPHP, 2).text(",").fixed(result.fee, 2).text(",").fixed(result.netPHP, 2);
+          for (double value : result.converted) text.text(",").fixed(value, 2);
+          text.text("\n");
+          cache.insert(snapshot->version, amountInPHP, ConversionCache::View::Csv, text.view());
+        }
+        out.write(text.view());
+        text.clear();
+        return true;
+      }
+
+      if (action == "cross") {
+        double amount;
+        string_view from, to;
+        if (!args.nextDouble(amount, 0, MAX_CROSS_AMOUNT, "amount") || !args.nextField(from, "source currency")) return false;
+        const size_t fromIndex = snapshot->matrix.indexOf(from);
+        if (fromIndex == RateMatrix::NOT_FOUND) return args.rejectField("unknown currency code");
+        if (!args.nextField(to, "target currency")) return false;
+        const size_t toIndex = snapshot->matrix.indexOf(to);
+        if (toIndex == RateMatrix::NOT_FOUND) return args.rejectField("unknown currency code");
+        if (!args.expectLineEnd()) return false;
+
+        Metrics::count(Counter::Conversions);
+        thread_local TextFormatter text;
+        text.text(from).text(",").text(to).text(",")
+            .fixed(snapshot->matrix.rate(fromIndex, toIndex), CurrencyTable::RATE_DECIMALS).text(",")
+            .fixed(snapshot->matrix.convert(amount, fromIndex, toIndex), 2).text("\n");
+        out.write(text.view());
+        text.clear();
+        return true;
+      }
+
+      if (action == "cache") {
+        if (!args.expectLineEnd()) return false;
+        ConversionCache::Statistics statistics = cache.statistics();
+        thread_local TextFormatter text;
+        text.text(to_string(statistics.hits)).text(",").text(to_string(statistics.misses)).text(",").fixed(statistics.hitRatio(), 4).text("\n");
+        out.write(text.view());
+        text.clear();
+        return true;
+      }
+
+      if (action != "rates" && action != "2") return args.rejectField("currency action must be convert, cross, rates or cache");
+      if (!args.expectLineEnd()) return false;
+
+      for (const CurrencyRate& currency : snapshot->table) {
+        out.write(currency.code);
+        out.put(',');
+        out.write(currency.symbol);
+        out.put(',');
+        out.write(number, static_cast<size_t>(FixedPoint::format(number, currency.rateFixed, CurrencyTable::RATE_DECIMALS) - number));
+        out.put('\n');
+      }
+      return true;
+    }
+
+    /**
+     * @brief Runs the Currency Exchange Calculator activity
+     * 
+     * Provides a menu for currency exchange operations
+     * including conversion and rate viewing.
+     */
+    Task<> runCurrencyCalculator(Session& session) const {
+      const int MIN_MENU_OPTION = 1;
+      const int MAX_MENU_OPTION = 3;
+      int menuChoice;
+
+      // Main calculator loop
+      while (true) {
+        UI::header(session.out, "Currency Exchange Calculator");
+
+        session.out << "Currency Exchange Options:\n"
+                    << "1. Exchange Currency\n"
+                    << "2. View Rates & Fee\n"
+                    << "3. Exit\n"
+        ;
+
+        UI::line(session.out);
+        menuChoice = co_await InputValidator::getValidatedChoice<MIN_MENU_OPTION, MAX_MENU_OPTION>(session, "Enter choice (1-3): ");
+
+        // Exit Currency Exchange Calculator Activity
+        if (menuChoice == 3) {
+          UI::goodbyeMessage(session.out, "Exiting Currency Exchange Calculator...\n");
+          UI::goodbyeMessage(session.out, "Successfully Navigated to Main Menu\n\n");
+          break;
+        }
+
+        switch (menuChoice) {
+          case 1:
+            co_await convertCurrency(session);
+            co_await UI::pauseBuffer(session);
+            break;
+          case 2:
+            displayRates(session.out);
+            co_await UI::pauseBuffer(session);
+            break;
+          default:
+            session.out << "[ERROR] Choice must be 1-3. Try again.\n";
+        }
+      }
+    }
+};
+
+// Comment
+// ======================================================= PROGRAM CLASS ==========================================================
+/**
+ * @class CommandIndex
+ * @brief Compile-time hash table from command names to table positions
+ *
+ * Built in a constant expression from any table with a string_view name
+ * member. A lookup hashes the name (FNV-1a), probes linearly from its
+ * slot, and compares the name once against the entry there to confirm.
+ * @tparam Slots Table size; must exceed the number of names
+ */
+template < size_t Slots >
+class CommandIndex {
+  public:
+    static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+    template < typename Entry, size_t Count >
+    constexpr CommandIndex(const Entry (&entries)[Count], string_view Entry::* name) {
+      static_assert(Count < Slots, "a CommandIndex needs at least one free slot");
+      for (size_t i = 0; i < Count; i++) {
+        size_t slot = hash(entries[i].*name) % Slots;
+        while (positions[slot] != 0) slot = (slot + 1) % Slots;
+        positions[slot] = static_cast<uint8_t>(i + 1);
+        names[slot] = entries[i].*name;
+      }
+    }
+
+    // @brief Returns the table position of name, or NOT_FOUND.
+    constexpr size_t find(string_view name) const {
+      for (size_t slot = hash(name) % Slots; positions[slot] != 0; slot = (slot + 1) % Slots) {
+        if (names[slot] == name) return positions[slot] - 1u;
+      }
+      return NOT_FOUND;
+    }
+
+    static constexpr uint64_t hash(string_view name) {
+      uint64_t value = 14695981039346656037ULL;
+      for (char c : name) value = (value ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+      return value;
+    }
+
+  private:
+    uint8_t positions[Slots] = {};   // Table position + 1, 0 for an empty slot
+    string_view names[Slots] = {};
+};
+
+/**
+ * @class Lazy
+ * @brief A module built on first use instead of at startup
+ *
+ * Construction runs once, under call_once, so concurrent sessions and
+ * server workers may race to the first use safely. Afterwards get()
+ * costs one acquire load.
+ */
+template < typename T >
+class Lazy {
+  public:
+    // @brief Builds a default-constructed T on first use.
+    Lazy() : make([]() { return make_unique<T>(); }) {}
+
+    // @brief Builds a T from make() on first use.
+    explicit Lazy(function<unique_ptr<T>()> make) : make(move(make)) {}
+
+    T& get() { return build(); }
+    const T& get() const { return build(); }
+    T* operator->() { return &build(); }
+    const T* operator->() const { return &build(); }
+
+  private:
+    mutable once_flag built;
+    mutable unique_ptr<T> value;
+    mutable function<unique_ptr<T>()> make;   // Released once value exists
+
+    T& build() const {
+      call_once(built, [this]() {
+        value = make();
+        make = nullptr;
+      });
+      return *value;
+    }
+};
+
+/**
+ * @class Program
+ * @brief Main controller class for the Programming Activity System
+ * 
+ * This class manages the application lifecycle, displays the main menu,
+ * and coordinates between different activity modules.
+ *
+ * Activities are registered in the MODULES table, which drives the menu,
+ * the script commands and the server protocol alike: adding an activity
+ * means adding its member and one row there.
+ */
+class Program {
+  private:
+    // Activity module instances, each built on its first dispatch
+    Lazy<VirtualStudentInfo> studentInfo;
+    Lazy<StudentGradeEvaluator> gradeEvaluator;
+    Lazy<TriangleActivity> triangleActivity;
+    Lazy<CurrencyCalculator> currencyCalculator;
+
+    // Interactive and headless entry points of each module, as registered in MODULES
+    static Task<> studentInfoMenu(const Program& program, Session& session) { return program.studentInfo->runStudentInfo(session); }
+    static Task<> gradeEvaluatorMenu(const Program& program, Session& session) { return program.gradeEvaluator->runStudentGradeEvaluator(session); }
+    static Task<> triangleMenu(const Program& program, Session& session) { return program.triangleActivity->runTriangleActivity(session); }
+    static Task<> currencyMenu(const Program& program, Session& session) { return program.currencyCalculator->runCurrencyCalculator(session); }
+
+    static bool studentInfoCommand(const Program&, FieldReader& args, OutputWriter& out) {
+      if (!args.expectLineEnd()) return false;
+      VirtualStudentInfo::writeStudentInfo(out);
+      return true;
+    }
+    static bool gradeEvaluatorCommand(const Program& program, FieldReader& args, OutputWriter& out) { return program.gradeEvaluator->evaluateCommand(args, out); }
+    static bool triangleCommand(const Program& program, FieldReader& args, OutputWriter& out) { return program.triangleActivity->renderCommand(args, out); }
+    static bool currencyCommand(const Program& program, FieldReader& args, OutputWriter& out) { return program.currencyCalculator->runCommand(args, out); }
+
+    /**
+     * @struct ModuleEntry
+     * @brief One main menu item: its labels and handlers
+     */
+    struct ModuleEntry {
+      string_view title;                                                // Main menu label
+      string_view command;                                              // Script command name
+      Task<> (*runMenu)(const Program&, Session&);                      // Interactive activity, nullptr for Exit
+      bool (*runCommand)(const Program&, FieldReader&, OutputWriter&);  // Headless command, nullptr for Exit
+    };
+
+    // The main menu, in display order; an item's ID is its position + 1
+    static constexpr ModuleEntry MODULES[] = {
+      {"Virtual Student Info", "info", &studentInfoMenu, &studentInfoCommand},
+      {"Student Grade Evaluator", "grades", &gradeEvaluatorMenu, &gradeEvaluatorCommand},
+      {"Triangle Loop Activity", "triangle", &triangleMenu, &triangleCommand},
+      {"Currency Exchange Calculator", "currency", &currencyMenu, &currencyCommand},
+      {"Exit Program", "exit", nullptr, nullptr}
+    };
+    static constexpr size_t MODULE_COUNT = size(MODULES);
+    static_assert(MODULE_COUNT <= 9, "menu IDs are matched as single digits");
+
+    static constexpr size_t COMMAND_SLOTS = 16;   // Hash slots for the command names
+    static constexpr CommandIndex<COMMAND_SLOTS> COMMANDS{MODULES, &ModuleEntry::command};
+
+    // Returns the MODULES position of a command ID ("1".."9") or name, or CommandIndex NOT_FOUND
+    static size_t findModule(string_view command) {
+      if (command.size() == 1 && command[0] >= '1' && command[0] < static_cast<char>('1' + MODULE_COUNT)) return static_cast<size_t>(command[0] - '1');
+      return COMMANDS.find(command);
+    }
+
+  public:
+    /**
+     * @brief Creates the program with the given exchange rates and grading policy
+     * @param currencyTable Rates used by the Currency Exchange Calculator
+     * @param gradingPolicy Policy used by the Student Grade Evaluator
+     */
+    explicit Program(CurrencyTable currencyTable = CurrencyTable::defaults(),
+                     StudentGradeEvaluator::GradingPolicy gradingPolicy = StudentGradeEvaluator::GradingPolicy::standard())
+      : gradeEvaluator([policy = move(gradingPolicy)]() mutable { return make_unique<StudentGradeEvaluator>(move(policy)); }),
+        currencyCalculator([table = move(currencyTable)]() mutable { return make_unique<CurrencyCalculator>(move(table)); }) {}
+
+    // @brief Returns the exchange-rate publisher of the currency module (building the module).
+    RateSnapshotPublisher& rateSnapshots() { return currencyCalculator->rateSnapshots(); }
+
+    /**
+     * @brief Runs one interactive session of the main menu
+     * @param session The frontend-driven input and output of the user
+     * 
+     * Displays welcome message and main menu in a loop,
+     * routing user choices to appropriate activity modules.
+     * Only reads shared state, so any number of sessions can share one Program.
+     */
+    Task<> runSession(Session& session) const {
+      int menuChoice;
+
+      // Display welcome banner
+      session.out << "\n" << string(45, '*') << "\n";
+      session.out << "   WELCOME TO PROGRAMMING ACTIVITY SYSTEM\n";
+      session.out << string(45, '*') << "\n";
+
+      // Main application loop
+      while (true) {
+        session.arena().reset();   // The previous activity's temporaries are all gone by now
+
+        UI::line(session.out);
+        session.out << ">>> ===== PROGRAMMING ACTIVITY MENU ===== <<<\n";
+        UI::line(session.out);
+
+        // Display dynamic menu from the MODULES table
+        for (size_t i = 0; i < MODULE_COUNT; ++i) {
+          session.out << "[" << i + 1 << "] " << MODULES[i].title << "\n";
+        }
+        UI::line(session.out);
+
+        // Get user's menu selection
+        char count[8];
+        pmr::string prompt("Enter choice (1-", session.arena().resource());
+        prompt.append(count, to_chars(count, count + sizeof(count), MODULE_COUNT).ptr).append("): ");
+        menuChoice = co_await InputValidator::getValidatedChoice(
+          session,
+          prompt,
+          1,
+          static_cast <int> (MODULE_COUNT)
+        );
+        Metrics::count(Counter::MenuDispatches);
+
+        // Route to selected activity (the validator only accepts registered IDs)
+        const ModuleEntry& module = MODULES[menuChoice - 1];
+        if (module.runMenu == nullptr) {
+          UI::goodbyeMessage(session.out, "Exiting program... Goodbye!\n");
+          co_return; // Exit application
+        }
+        co_await module.runMenu(*this, session);
+      }
+    }
+
+    /**
+     * @brief Main application entry point
+     * 
+     * The console frontend of runSession(): feeds standard input to
+     * the session line by line and lets it write straight to cout.
+     * Returns when the user exits or standard input ends.
+     */
+    void run() const {
+      Session session(cout);
+      session.start(runSession(session));
+
+      string line;
+      while (!session.finished()) {
+        if (!getline(cin, line)) {
+          session.close();
+          break;
+        }
+        if (!cin.eof()) line += '\n';
+        session.feed(line);
+      }
+    }
+
+    // @brief Outcome of one script command line.
+    enum class CommandStatus { Done, Failed, Skipped, Exit };
+
+    /**
+     * @brief Runs the current line of a command reader through the menu dispatch
+     * @param args Reader positioned on the line (after nextLine())
+     * @param out Receives the command result
+     * @return Skipped for blank and "#" comment lines, Failed (with the reason
+     *         in args.error()) for invalid commands, Exit for "exit"
+     *
+     * Only reads shared state, so different threads may run commands at once.
+     */
+    CommandStatus runCommand(FieldReader& args, OutputWriter& out) const {
+      string_view line = FieldReader::trim(args.line());
+      if (line.empty() || line.front() == '#') return CommandStatus::Skipped;
+
+      Metrics::ScopedTimer timer(Timer::ScriptCommand);
+      Metrics::count(Counter::ScriptCommands);
+
+      string_view command;
+      args.nextField(command, "command");
+
+      // Route to the selected activity, as run() does
+      size_t module = findModule(command);
+      bool ok;
+      if (module != CommandIndex<COMMAND_SLOTS>::NOT_FOUND) {
+        if (MODULES[module].runCommand == nullptr) return CommandStatus::Exit;
+        ok = MODULES[module].runCommand(*this, args, out);
+      } else if (command == "metrics") {
+        ok = writeMetrics(args, out);
+      } else {
+        ok = args.rejectField("unknown command '" + string(command) + "'");
+      }
+      return ok ? CommandStatus::Done : CommandStatus::Failed;
+    }
+
+    /**
+     * @brief Runs a command script through the menu dispatch, headlessly
+     * @param script One command per line; blank lines and "#" comments are skipped
+     * @param out Receives the command results, with no banners or prompts
+     * @param errors Receives one "[ERROR] Line N, column C: ..." message per failed command
+     * @return The number of commands that failed
+     *
+     * Each line starts with a main menu ID or its MODULES command name,
+     * followed by what the menu would otherwise prompt for:
+     *   1 | info
+     *   2 | grades <prelim> <midterm> <prefinal> <final>   (one grade per --policy period)
+     *   3 | triangle <right|inverted|both> <height>
+     *   4 | currency <convert <amount> | cross <amount> <FROM> <TO> | rates | cache>
+     *   5 | exit
+     *   metrics [prometheus|json]
+     * A failed command is reported and the script continues; "exit" stops it.
+     */
+    size_t runScript(string_view script, OutputWriter& out, ostream& errors) const {
+      size_t failures = 0;
+      FieldReader args(script, ' ');
+
+      while (args.nextLine()) {
+        CommandStatus status = runCommand(args, out);
+        if (status == CommandStatus::Exit) break;
+        if (status == CommandStatus::Failed) {
+          const ParseError& error = args.error();
+          errors << "[ERROR] Line " << error.line << ", column " << error.column << ": " << error.message << "\n";
+          failures++;
+        }
+      }
+      return failures;
+    }
+
+  private:
+    // Writes the current Metrics snapshot for "metrics [prometheus|json]"
+    static bool writeMetrics(FieldReader& args, OutputWriter& out) {
+      string_view format = "prometheus";
+      if (!FieldReader::trim(args.line()).empty() && !args.nextField(format, "metrics format")) return false;
+      if (format != "prometheus" && format != "json") return args.rejectField("metrics format must be prometheus or json");
+      if (!args.expectLineEnd()) return false;
+
+      ostringstream text;
+      if (format == "json") Metrics::writeJson(text, Metrics::snapshot());
+      else Metrics::writePrometheus(text, Metrics::snapshot());
+      out.write(text.str());
+      return true;
+    }
+};
+
+// ================================================== REQUEST SERVER CLASS ==================================================
+#if defined(__linux__)
+/**
+ * @class RequestServer
+ * @brief Serves script commands to many clients over a Unix or TCP socket
+ *
+ * One epoll thread accepts connections and reads and writes them without
+ * blocking. Each complete request line is a Program::runScript() command
+ * and gets exactly one response:
+ *   OK <length>\n<length bytes of output>
+ *   ERR <column> <message>\n
+ * Blank and "#" lines get no response, and "exit" closes the connection.
+ *
+ * The lines a connection has buffered run as one task on the pool, so
+ * different connections are served concurrently. Responses on one
+ * connection always come back in request order. Program stays resident
+ * and is only read, and rates come from its RCU snapshots.
+ *
+ * In session mode every connection instead gets its own interactive
+ * menu (Program::runSession()). The sessions are coroutines resumed on
+ * the event loop thread as their bytes arrive, so idle users cost only
+ * their suspended frames.
+ */
+class RequestServer {
+  public:
+    static constexpr size_t MAX_REQUEST_BYTES = 1 << 16;    // Longest request line accepted
+    static constexpr size_t MAX_PENDING_OUTPUT = 1 << 22;   // Unsent response bytes before a connection's next batch (and reading) waits
+
+    /**
+     * @brief Prepares a server for the given program
+     * @param program Commands run against this; it must outlive the server
+     * @param threadCount Workers that run the requests
+     * @param menuSessions true to give each connection the interactive menu instead of the line protocol
+     */
+    RequestServer(const Program& program, unsigned threadCount, bool menuSessions = false)
+      : program(program), menuSessions(menuSessions), pool(menuSessions ? 1 : threadCount) {}
+
+    ~RequestServer() {
+      // Running tasks still post to completed and wakeFd, so let them finish before anything closes
+      pool.shutdown();
+      for (auto& [id, connection] : connections) ::close(connection.fd);
+      if (listenFd >= 0) ::close(listenFd);
+      if (wakeFd >= 0) ::close(wakeFd);
+      if (epollFd >= 0) ::close(epollFd);
+      if (!unixPath.empty()) ::unlink(unixPath.c_str());
+    }
+
+    RequestServer(const RequestServer&) = delete;
+    RequestServer& operator=(const RequestServer&) = delete;
+
+    /**
+     * @brief Binds the listening socket
+     * @param address "unix:<path>" or "tcp:<host>:<port>" (an empty host listens on all interfaces)
+     * @return false (after printing an error) if the address is invalid or cannot be bound
+     */
+    bool listen(const string& address) {
+      epollFd = epoll_create1(EPOLL_CLOEXEC);
+      wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      if (epollFd < 0 || wakeFd < 0) return fail("cannot create the event loop");
+
+      if (address.rfind("unix:", 0) == 0) {
+        sockaddr_un local = {};
+        local.sun_family = AF_UNIX;
+        string path = address.substr(5);
+        if (path.empty() || path.size() >= sizeof(local.sun_path)) return fail("invalid socket path: " + path);
+        memcpy(local.sun_path, path.c_str(), path.size() + 1);
+
+        // Replace a stale socket from an earlier run, but never delete anything else
+        struct stat existing;
+        if (::lstat(path.c_str(), &existing) == 0) {
+          if (!S_ISSOCK(existing.st_mode)) return fail("cannot bind " + path + ": path exists and is not a socket");
+          ::unlink(path.c_str());
+        }
+
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) return fail("cannot bind " + path);
+        unixPath = path;
+      } else if (address.rfind("tcp:", 0) == 0 && address.rfind(':') > 3) {
+        size_t colon = address.rfind(':');
+        string host = address.substr(4, colon - 4);
+        string port = address.substr(colon + 1);
+
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        addrinfo* found = nullptr;
+        if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &found) != 0) return fail("cannot resolve " + address);
+
+        for (addrinfo* entry = found; entry != nullptr && listenFd < 0; entry = entry->ai_next) {
+          listenFd = ::socket(entry->ai_family, entry->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, entry->ai_protocol);
+          if (listenFd < 0) continue;
+          int reuse = 1;
+          setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+          if (::bind(listenFd, entry->ai_addr, entry->ai_addrlen) != 0) {
+            ::close(listenFd);
+            listenFd = -1;
+          }
+        }
+        freeaddrinfo(found);
+        if (listenFd < 0) return fail("cannot bind " + address);
+      } else {
+        return fail("server address must be unix:<path> or tcp:<host>:<port>");
+      }
+
+      if (::listen(listenFd, SOMAXCONN) != 0) return fail("cannot listen on " + address);
+      watch(listenFd, EPOLLIN, LISTEN_ID, EPOLL_CTL_ADD);
+      watch(wakeFd, EPOLLIN, WAKE_ID, EPOLL_CTL_ADD);
+      return true;
+    }
+
+    /**
+     * @brief Serves requests until stop() is called
+     */
+    void run() {
+      epoll_event events[64];
+      while (!stopping) {
+        int ready = epoll_wait(epollFd, events, 64, -1);
+        if (ready < 0 && errno != EINTR) break;
+
+        for (int i = 0; i < ready; i++) {
+          uint64_t id = events[i].data.u64;
+          if (id == LISTEN_ID) acceptConnections();
+          else if (id == WAKE_ID) collectResponses();
+          else serviceConnection(id, events[i].events);
+        }
+      }
+    }
+
+    // @brief Makes run() return; safe to call from any thread or from a signal handler.
+    void stop() {
+      stopping = true;
+      uint64_t one = 1;
+      ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+      (void) ignored;
+    }
+
+  private:
+    static constexpr uint64_t LISTEN_ID = 0;   // epoll tags for the two fixed descriptors
+    static constexpr uint64_t WAKE_ID = 1;
+
+    // An interactive menu conversation and the output it has not sent yet
+    struct MenuSession {
+      ostringstream output;
+      Session session{output};
+    };
+
+    struct Connection {
+      int fd = -1;
+      unique_ptr<MenuSession> menu;   // Set in session mode
+      string input;           // Bytes received but not yet dispatched
+      string output;          // Responses not yet sent
+      size_t sent = 0;        // Bytes of output already written
+      bool busy = false;      // A batch of this connection's lines is on the pool
+      bool peerClosed = false;  // The client will send nothing more but may still read
+      bool broken = false;      // The socket failed or hung up completely; close right away
+      bool closing = false;     // Close once output is sent ("exit" or a protocol error)
+      uint32_t watched = EPOLLIN | EPOLLRDHUP;   // Events registered with epoll
+    };
+
+    struct Completion {
+      uint64_t id;
+      string output;
+      bool exitRequested;
+    };
+
+    const Program& program;
+    bool menuSessions;
+    int epollFd = -1;
+    int listenFd = -1;
+    int wakeFd = -1;
+    string unixPath;
+    atomic<bool> stopping{false};
+    uint64_t nextId = WAKE_ID + 1;
+    unordered_map<uint64_t, Connection> connections;
+
+    mutex completedLock;   // Guards completed, filled by the workers
+    vector<Completion> completed;
+
+    WorkStealingPool pool;   // Drained first thing in ~RequestServer(), before the descriptors its tasks write to close
+
+    bool fail(const string& message) {
+      cerr << "[ERROR] " << message << "\n";
+      return false;
+    }
+
+    void watch(int fd, uint32_t events, uint64_t id, int operation) {
+      epoll_event event = {};
+      event.events = events;
+      event.data.u64 = id;
+      epoll_ctl(epollFd, operation, fd, &event);
+    }
+
+    void acceptConnections() {
+      while (true) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;   // EAGAIN once the backlog is empty
+
+        uint64_t id = nextId++;
+        Connection& connection = connections[id];
+        connection.fd = fd;
+        watch(fd, EPOLLIN | EPOLLRDHUP, id, EPOLL_CTL_ADD);
+
+        if (menuSessions) {
+          connection.menu = make_unique<MenuSession>();
+          connection.menu->session.start(program.runSession(connection.menu->session));
+          advanceMenu(connection);
+          sendOutput(id, connection);
+        }
+      }
+    }
+
+    void serviceConnection(uint64_t id, uint32_t events) {
+      auto found = connections.find(id);
+      if (found == connections.end()) return;
+      Connection& connection = found->second;
+
+      if (events & (EPOLLHUP | EPOLLERR)) connection.broken = true;
+      if ((events & (EPOLLIN | EPOLLRDHUP)) && !connection.broken) {
+        char block[1 << 14];
+        while (true) {
+          ssize_t received = ::read(connection.fd, block, sizeof(block));
+          if (received > 0) {
+            connection.input.append(block, static_cast<size_t>(received));
+            if (connection.input.size() > MAX_REQUEST_BYTES) break;   // the rest waits until this much is consumed
+            continue;
+          }
+          if (received == 0) connection.peerClosed = true;
+          else if (errno == EINTR) continue;
+          else if (errno != EAGAIN) connection.broken = true;
+          break;
+        }
+      }
+
+      if (connection.menu) advanceMenu(connection);
+      else dispatch(id, connection);
+      sendOutput(id, connection);
+    }
+
+    // Feeds received bytes to the connection's menu session and queues what it displays
+    void advanceMenu(Connection& connection) {
+      Session& session = connection.menu->session;
+
+      // Same limits as dispatch(): no over-long line, and no more input while output is backed up
+      size_t end = connection.input.rfind('\n');
+      size_t partial = connection.input.size() - (end == string::npos ? 0 : end + 1);
+      if (partial > MAX_REQUEST_BYTES) {
+        connection.input.clear();
+        connection.output += "[ERROR] Input line too long. Closing the session.\n";
+        connection.closing = true;
+        return;
+      }
+
+      // Whole lines only, so a partial line waits here (bounded above) rather than in the session
+      if (connection.output.size() - connection.sent <= MAX_PENDING_OUTPUT) {
+        size_t complete = connection.peerClosed ? connection.input.size() : (end == string::npos ? 0 : end + 1);
+        if (complete > 0) {
+          session.feed(string_view(connection.input).substr(0, complete));
+          connection.input.erase(0, complete);
+        }
+        if (connection.peerClosed) session.close();
+      }
+
+      ostringstream& output = connection.menu->output;
+      connection.output += output.view();
+      output.str("");
+      if (session.finished()) connection.closing = true;
+    }
+
+    // Hands every complete buffered line to the pool as one in-order batch
+    void dispatch(uint64_t id, Connection& connection) {
+      if (connection.closing) return;
+
+      size_t end = connection.input.rfind('\n');
+      size_t partial = connection.input.size() - (end == string::npos ? 0 : end + 1);
+      if (partial > MAX_REQUEST_BYTES) {
+        connection.input.clear();
+        connection.output += "ERR 1 request line too long\n";
+        connection.closing = true;
+        return;
+      }
+
+      if (connection.busy || connection.output.size() - connection.sent > MAX_PENDING_OUTPUT) return;
+      if (end == string::npos && connection.peerClosed) end = connection.input.size() - 1;   // unterminated last line
+      if (end == string::npos || connection.input.empty()) return;
+
+      string batch = connection.input.substr(0, end + 1);
+      connection.input.erase(0, end + 1);
+      connection.busy = true;
+
+      pool.submit([this, id, batch = move(batch)]() {
+        Completion result{id, string(), false};
+        result.exitRequested = respond(batch, result.output);
+        {
+          lock_guard<mutex> guard(completedLock);
+          completed.push_back(move(result));
+        }
+        uint64_t one = 1;
+        ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+        (void) ignored;
+      });
+    }
+
+    // Runs a batch of request lines and frames each result; returns true if one was "exit"
+    bool respond(string_view batch, string& response) const {
+      FieldReader args(batch, ' ');
+      thread_local string output;   // Reused by every batch this worker runs
+      char number[24];
+
+      while (args.nextLine()) {
+        output.clear();
+        Program::CommandStatus status;
+        {
+          OutputWriter out(output);
+          status = program.runCommand(args, out);
+        }
+
+        if (status == Program::CommandStatus::Exit) return true;
+        if (status == Program::CommandStatus::Done) {
+          response.append("OK ").append(number, to_chars(number, number + sizeof(number), output.size()).ptr) += '\n';
+          response += output;
+        } else if (status == Program::CommandStatus::Failed) {
+          response.append("ERR ").append(number, to_chars(number, number + sizeof(number), args.error().column).ptr) += ' ';
+          response.append(args.error().message) += '\n';
+        }
+      }
+      return false;
+    }
+
+    void collectResponses() {
+      uint64_t count;
+      ssize_t ignored = ::read(wakeFd, &count, sizeof(count));
+      (void) ignored;
+
+      vector<Completion> finished;
+      {
+        lock_guard<mutex> guard(completedLock);
+        finished.swap(completed);
+      }
+
+      for (Completion& result : finished) {
+        auto found = connections.find(result.id);
+        if (found == connections.end()) continue;   // the client went away meanwhile
+        Connection& connection = found->second;
+
+        connection.output += result.output;
+        connection.busy = false;
+        connection.closing |= result.exitRequested;
+        dispatch(result.id, connection);
+        sendOutput(result.id, connection);
+      }
+    }
+
+    // Writes what the socket accepts, then closes the connection if it is finished
+    void sendOutput(uint64_t id, Connection& connection) {
+      while (connection.sent < connection.output.size() && !connection.broken) {
+        ssize_t written = ::send(connection.fd, connection.output.data() + connection.sent,
+                                 connection.output.size() - connection.sent, MSG_NOSIGNAL);
+        if (written < 0) {
+          if (errno == EINTR) continue;
+          if (errno != EAGAIN) connection.broken = true;
           break;
         }
+        connection.sent += static_cast<size_t>(written);
+      }
+
+      bool drained = connection.sent == connection.output.size();
+      if (drained) {
+        connection.output.clear();
+        connection.sent = 0;
+      }
+
+      // A pending batch for a broken connection is dropped by collectResponses()
+      bool done = !connection.busy && drained && (connection.closing || (connection.peerClosed && connection.input.empty()));
+      if (connection.broken || done) {
+        ::close(connection.fd);
+        connections.erase(id);
+        return;
+      }
+
+      // Ask for EPOLLOUT only while output is waiting. Stop reading a peer that has finished sending,
+      // or one that is too far ahead: unread bytes stay in the kernel and epoll reports them once resumed
+      const bool backlogged = connection.output.size() - connection.sent > MAX_PENDING_OUTPUT
+                              || connection.input.size() > MAX_REQUEST_BYTES;
+      uint32_t events = 0;
+      if (!connection.peerClosed && !backlogged) events |= EPOLLIN | EPOLLRDHUP;
+      if (!drained) events |= EPOLLOUT;
+      if (events != connection.watched) {
+        watch(connection.fd, events, id, EPOLL_CTL_MOD);
+        connection.watched = events;
+      }
+    }
+};
+#endif
+
+// ================================================== LOAD GENERATOR CLASS ==================================================
+/**
+ * @class LoadGenerator
+ * @brief Replays a command workload headlessly or against a --serve socket and measures its latency
+ *
+ * A workload is a list of Program::runScript() command lines. It is
+ * either recorded (a script file) or synthesized from a mix of currency
+ * conversions, grade evaluations and triangle renders. Each run puts a
+ * number of workers on it for a fixed time, replaying the list round robin.
+ * A "headless" worker is a thread calling Program::runCommand(). A socket
+ * worker holds one blocking connection to a RequestServer.
+ *
+ * Workers send back to back (closed loop) or, given a target rate, on a
+ * fixed schedule (open loop). In the open loop a request's latency
+ * counts from when it was due rather than when it was sent. A server
+ * that stalls therefore shows up as latency, not just as fewer requests.
+ *
+ * Latencies go into Metrics' log-linear histograms (about 6% resolution),
+ * one per worker, merged once the run ends.
+ */
+class LoadGenerator {
+  public:
+    static constexpr size_t SYNTHETIC_REQUESTS = 4096;   // Distinct commands in a synthetic workload
+    static constexpr unsigned MAX_CONCURRENCY = 1024;    // Workers (threads or connections) per run
+    static constexpr double MAX_REQUESTS_PER_SECOND = 1e7;   // Open-loop target rate, summed over the workers
+    static constexpr double MAX_DURATION_SECONDS = 3600;     // Length of one run
+
+    /**
+     * @struct Mix
+     * @brief Relative weights of the synthetic command kinds
+     */
+    struct Mix {
+      unsigned currency = 60;
+      unsigned grades = 30;
+      unsigned triangle = 10;
+    };
+
+    /**
+     * @struct Result
+     * @brief Outcome of one run at one concurrency
+     */
+    struct Result {
+      unsigned concurrency = 0;
+      double seconds = 0;                      // Wall time from the first request due to the last response
+      uint64_t errors = 0;                     // Failed commands (ERR responses)
+      Metrics::Snapshot::Histogram latency;    // Every request, failed ones included
+
+      double requestsPerSecond() const { return seconds > 0 ? static_cast<double>(latency.count) / seconds : 0; }
+    };
+
+    /**
+     * @brief Prepares a generator for one target
+     * @param target "headless", "unix:<path>" or "tcp:<host>:<port>"
+     * @param requests Command lines, each ending in '\n'
+     * @param program Runs the headless requests; unused (and may be nullptr) for socket targets
+     */
+    LoadGenerator(string target, vector<string> requests, const Program* program)
+      : target(move(target)), requests(move(requests)), program(program) {}
+
+    /**
+     * @brief Parses "<currency>,<grades>,<triangle>" weights, e.g. "60,30,10"
+     * @return false if a weight is missing or not a number, or all are 0
+     */
+    static bool parseMix(string_view text, Mix& mix) {
+      unsigned* weights[] = {&mix.currency, &mix.grades, &mix.triangle};
+      const char* position = text.data();
+      const char* end = text.data() + text.size();
+      for (size_t i = 0; i < 3; i++) {
+        if (i > 0 && (position == end || *position++ != ',')) return false;
+        auto [next, status] = from_chars(position, end, *weights[i]);
+        if (status != errc()) return false;
+        position = next;
+      }
+      return position == end && mix.currency + mix.grades + mix.triangle > 0;
+    }
+
+    /**
+     * @brief Generates a reproducible workload in the given mix
+     * @param mix Relative weights of the three command kinds
+     * @param gradeCount Grades per "grades" command (the policy's period count)
+     * @param count Commands to generate
+     *
+     * Amounts, grades and triangle heights are drawn uniformly from the
+     * ranges the modules accept, from a fixed seed.
+     */
+    static vector<string> synthesize(const Mix& mix, size_t gradeCount, size_t count = SYNTHETIC_REQUESTS) {
+      mt19937_64 random(20240601);
+      discrete_distribution<int> kind({static_cast<double>(mix.currency), static_cast<double>(mix.grades), static_cast<double>(mix.triangle)});
+      uniform_int_distribution<int64_t> centavos(CurrencyCalculator::MIN_AMOUNT * 100, CurrencyCalculator::MAX_AMMOUNT * 100);
+      uniform_int_distribution<int> hundredths(StudentGradeEvaluator::MIN_GRADE * 100, StudentGradeEvaluator::MAX_GRADE * 100);
+      uniform_int_distribution<int> height(TriangleActivity::MIN_HEIGHT, TriangleActivity::MAX_HEIGHT);
+      const char* SHAPES[] = {"right", "inverted", "both"};
+
+      vector<string> workload;
+      workload.reserve(count);
+      char number[32];
+      auto appendNumber = [&](string& line, double value) { line.append(number, to_chars(number, number + sizeof(number), value).ptr); };
+      for (size_t i = 0; i < count; i++) {
+        string line;
+        switch (kind(random)) {
+          case 0:
+            line = "currency convert ";
+            appendNumber(line, static_cast<double>(centavos(random)) / 100);
+            break;
+          case 1:
+            line = "grades";
+            for (size_t g = 0; g < gradeCount; g++) {
+              line += ' ';
+              appendNumber(line, hundredths(random) / 100.0);
+            }
+            break;
+          default:
+            line.append("triangle ").append(SHAPES[random() % 3]) += ' ';
+            line += to_string(height(random));
+        }
+        workload.push_back(move(line += '\n'));
+      }
+      return workload;
+    }
+
+    /**
+     * @brief Splits a recorded script into a workload
+     * @param text Script text, one command per line
+     *
+     * Blank lines, "#" comments and "exit" are left out; they get no
+     * response from the server and would stall a closed-loop worker.
+     */
+    static vector<string> loadWorkload(string_view text) {
+      vector<string> workload;
+      FieldReader reader(text, ' ');
+      while (reader.nextLine()) {
+        string_view line = FieldReader::trim(reader.line());
+        if (line.empty() || line.front() == '#') continue;
+        string_view command = line.substr(0, line.find(' '));
+        if (command == "exit" || command == "5") continue;
+        workload.emplace_back(line) += '\n';
+      }
+      return workload;
+    }
+
+    /**
+     * @brief Runs the workload at one concurrency
+     * @param concurrency Workers, each a thread and, for socket targets, a connection
+     * @param requestsPerSecond Open-loop target rate summed over the workers, or 0 for a closed loop
+     * @param seconds How long the workers keep sending
+     * @param result Receives the latencies, errors and wall time
+     * @return false (after printing an error) if a connection cannot be made or is lost
+     */
+    bool run(unsigned concurrency, double requestsPerSecond, double seconds, Result& result) {
+      result = Result();
+      result.concurrency = concurrency;
+
+      vector<int> sockets(concurrency, -1);
+      if (target != "headless") {
+        for (int& fd : sockets) {
+          fd = connectTo(target);
+          if (fd < 0) {
+            closeAll(sockets);
+            return false;
+          }
+        }
+      }
 
-        switch (menuChoice) {
-          case 1:
-            convertCurrency();
-            UI::pauseBuffer();
-            break;
-          case 2:
-            displayRates();
-            UI::pauseBuffer();
-            break;
-          default:
-            cout << "[ERROR] Choice must be 1-3. Try again.\n";
+      // Every worker starts on the same tick; open-loop workers are staggered evenly over one interval
+      using Clock = chrono::steady_clock;
+      const Clock::time_point start = Clock::now() + chrono::milliseconds(10);
+      const Clock::time_point deadline = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(seconds));
+      const Clock::duration interval = requestsPerSecond > 0
+        ? chrono::duration_cast<Clock::duration>(chrono::duration<double>(concurrency / requestsPerSecond))
+        : Clock::duration::zero();
+
+      vector<Result> partial(concurrency);
+      atomic<bool> lost = false;
+      vector<thread> workers;
+      for (unsigned worker = 0; worker < concurrency; worker++) {
+        workers.emplace_back([&, worker]() {
+          Result& mine = partial[worker];
+          size_t next = worker * requests.size() / concurrency;
+          Clock::time_point due = start + interval * worker / concurrency;
+          string buffer;
+          this_thread::sleep_until(due);
+
+          while (!lost.load(memory_order_relaxed)) {
+            Clock::time_point sent = Clock::now();
+            if (sent >= deadline) break;
+            if (interval != Clock::duration::zero()) {
+              if (due >= deadline) break;
+              // sleep_until() can wake tens of microseconds late, and that would count as latency
+              if (due - sent > SPIN_AHEAD) this_thread::sleep_until(due - SPIN_AHEAD);
+              while (Clock::now() < due) this_thread::yield();
+              sent = due;
+              due += interval;
+            }
+
+            int status = sockets[worker] >= 0 ? sendRequest(sockets[worker], requests[next], buffer) : runHeadless(requests[next]);
+            if (status < 0) {
+              lost = true;
+              break;
+            }
+            mine.latency.record(static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(Clock::now() - sent).count()));
+            mine.errors += status == 0;
+            if (++next == requests.size()) next = 0;
+          }
+        });
+      }
+      for (thread& worker : workers) worker.join();
+      result.seconds = chrono::duration<double>(Clock::now() - start).count();
+      closeAll(sockets);
+
+      for (const Result& mine : partial) {
+        result.latency.merge(mine.latency);
+        result.errors += mine.errors;
+      }
+      if (lost) cerr << "[ERROR] Connection to " << target << " lost\n";
+      return !lost;
+    }
+
+    // @brief Writes one aligned line per concurrency, latencies in microseconds.
+    static void writeText(ostream& out, const vector<Result>& results) {
+      out << right << setw(12) << "concurrency" << setw(12) << "requests" << setw(9) << "errors" << setw(14) << "requests/s"
+          << setw(11) << "p50 us" << setw(11) << "p99 us" << setw(11) << "p999 us" << setw(11) << "max us" << "\n";
+      for (const Result& result : results) {
+        out << fixed << setprecision(1) << setw(12) << result.concurrency << setw(12) << result.latency.count
+            << setw(9) << result.errors << setw(14) << result.requestsPerSecond()
+            << setw(11) << result.latency.percentile(50) / 1e3 << setw(11) << result.latency.percentile(99) / 1e3
+            << setw(11) << result.latency.percentile(99.9) / 1e3 << setw(11) << result.latency.maxNanos / 1e3 << "\n";
+      }
+      out << defaultfloat << setprecision(6);
+    }
+
+    // @brief Writes the results as one JSON document.
+    static void writeJson(ostream& out, const string& target, double requestsPerSecond, const vector<Result>& results) {
+      out << "{\n  \"target\": \"" << target << "\",\n  \"mode\": \"" << (requestsPerSecond > 0 ? "open" : "closed") << "\""
+          << fixed << setprecision(1) << ",\n  \"target_requests_per_second\": " << requestsPerSecond << ",\n  \"runs\": [";
+      for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"concurrency\": " << result.concurrency
+            << ", \"requests\": " << result.latency.count
+            << ", \"errors\": " << result.errors
+            << ", \"seconds\": " << setprecision(3) << result.seconds << setprecision(1)
+            << ", \"requests_per_second\": " << result.requestsPerSecond()
+            << ", \"p50_ns\": " << result.latency.percentile(50)
+            << ", \"p99_ns\": " << result.latency.percentile(99)
+            << ", \"p999_ns\": " << result.latency.percentile(99.9)
+            << ", \"max_ns\": " << result.latency.maxNanos << "}";
+      }
+      out << "\n  ]\n}\n" << defaultfloat << setprecision(6);
+    }
+
+  private:
+    static constexpr chrono::microseconds SPIN_AHEAD{200};   // Open-loop workers stop sleeping this long before a request is due
+
+    string target;
+    vector<string> requests;
+    const Program* program;
+
+    // Runs one command in this process; returns 1 if it succeeded, 0 if it failed
+    int runHeadless(const string& request) const {
+      thread_local string output;
+      output.clear();
+      FieldReader args(request, ' ');
+      args.nextLine();
+      Program::CommandStatus status;
+      {
+        OutputWriter out(output);
+        status = program->runCommand(args, out);
+      }
+      return status == Program::CommandStatus::Failed ? 0 : 1;
+    }
+
+#if defined(__linux__)
+    /**
+     * @brief Opens a blocking connection to a RequestServer
+     * @param address "unix:<path>" or "tcp:<host>:<port>", as given to --serve
+     * @return The socket, or -1 (after printing an error)
+     */
+    static int connectTo(const string& address) {
+      int fd = -1;
+      if (address.rfind("unix:", 0) == 0) {
+        sockaddr_un remote = {};
+        remote.sun_family = AF_UNIX;
+        string path = address.substr(5);
+        if (!path.empty() && path.size() < sizeof(remote.sun_path)) {
+          memcpy(remote.sun_path, path.c_str(), path.size() + 1);
+          fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+          if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) != 0) {
+            ::close(fd);
+            fd = -1;
+          }
+        }
+      } else if (address.rfind("tcp:", 0) == 0 && address.rfind(':') > 3) {
+        size_t colon = address.rfind(':');
+        string host = address.substr(4, colon - 4);
+        string port = address.substr(colon + 1);
+
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* found = nullptr;
+        if (getaddrinfo(host.empty() ? "localhost" : host.c_str(), port.c_str(), &hints, &found) == 0) {
+          for (addrinfo* entry = found; entry != nullptr && fd < 0; entry = entry->ai_next) {
+            fd = ::socket(entry->ai_family, entry->ai_socktype | SOCK_CLOEXEC, entry->ai_protocol);
+            if (fd < 0) continue;
+            if (::connect(fd, entry->ai_addr, entry->ai_addrlen) != 0) {
+              ::close(fd);
+              fd = -1;
+            }
+          }
+          freeaddrinfo(found);
         }
+        // One small request per round trip: don't let Nagle hold it back
+        int noDelay = 1;
+        if (fd >= 0) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+      } else {
+        cerr << "[ERROR] load target must be headless, unix:<path> or tcp:<host>:<port>\n";
+        return -1;
+      }
+      if (fd < 0) cerr << "[ERROR] Cannot connect to " << address << "\n";
+      return fd;
+    }
+
+    /**
+     * @brief Sends one request line and reads its whole response
+     * @param buffer Scratch space for the response, reused between requests
+     * @return 1 for "OK", 0 for "ERR", -1 if the connection failed
+     */
+    static int sendRequest(int fd, const string& request, string& buffer) {
+      for (size_t sent = 0; sent < request.size();) {
+        ssize_t written = ::send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) return -1;
+        sent += static_cast<size_t>(written);
+      }
+
+      // "OK <length>\n" plus length bytes, or a single "ERR <column> <message>\n" line
+      buffer.clear();
+      size_t expected = 0;   // Whole response size, once the status line is in
+      char chunk[1 << 14];
+      while (expected == 0 || buffer.size() < expected) {
+        ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) return -1;
+        buffer.append(chunk, static_cast<size_t>(received));
+        size_t newline = expected == 0 ? buffer.find('\n') : string::npos;
+        if (newline == string::npos) continue;
+        if (buffer.rfind("ERR ", 0) == 0) return 0;
+        if (buffer.rfind("OK ", 0) != 0) return -1;
+        size_t length = 0;
+        from_chars(buffer.data() + 3, buffer.data() + newline, length);
+        expected = newline + 1 + length;
+      }
+      return 1;
+    }
+#else
+    static int connectTo(const string& address) {
+      cerr << "[ERROR] Cannot connect to " << address << ": socket targets need Linux\n";
+      return -1;
+    }
+
+    static int sendRequest(int, const string&, string&) { return -1; }
+#endif
+
+    static void closeAll(vector<int>& sockets) {
+      for (int& fd : sockets) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
       }
     }
 };
 
-// Comment
-// ======================================================= PROGRAM CLASS ==========================================================
+// ================================================== BENCHMARK SUITE CLASS ==================================================
 /**
- * @class Program
- * @brief Main controller class for the Programming Activity System
- * 
- * This class manages the application lifecycle, displays the main menu,
- * and coordinates between different activity modules.
+ * @class BenchmarkSuite
+ * @brief Built-in microbenchmarks for every module's hot path
+ *
+ * Each case runs its body once to warm up, then times a number of
+ * repetitions individually with steady_clock. The report gives the run
+ * time percentiles and the throughput at the median, as text or JSON.
+ * Inputs are generated from a fixed seed, so runs are comparable across
+ * builds and releases. The startup cases track cold-start cost: a new
+ * Program serving its first command to each module, and (on Linux) a
+ * whole new process running one command.
  */
-class Program {
-  private:
-    // Available menu options
-    vector <string> menuItems = {
-      "Virtual Student Info",
-      "Student Grade Evaluator",
-      "Triangle Loop Activity",
-      "Currency Exchange Calculator",
-      "Exit Program"
+class BenchmarkSuite {
+  public:
+    /**
+     * @struct Result
+     * @brief Timings of one benchmark case
+     */
+    struct Result {
+      string name;
+      string unit;                // What one item is ("conversions", "rows", ...)
+      size_t itemsPerRun = 0;
+      vector<double> runNanos;    // Sorted wall time of each timed repetition
+
+      double percentile(double p) const {
+        size_t index = static_cast<size_t>(p / 100.0 * static_cast<double>(runNanos.size() - 1) + 0.5);
+        return runNanos[index];
+      }
+
+      double itemsPerSecond() const { return static_cast<double>(itemsPerRun) * 1e9 / percentile(50); }
     };
 
-    // Activity module instances
-    VirtualStudentInfo studentInfo;
-    StudentGradeEvaluator gradeEvaluator;
-    TriangleActivity triangleActivity;
-    CurrencyCalculator currencyCalculator;
+    static constexpr unsigned MAX_REPETITIONS = 10000;      // Upper bound accepted for --repetitions
 
-  public:
     /**
-     * @brief Main application entry point
-     * 
-     * Displays welcome message and main menu in a loop,
-     * routing user choices to appropriate activity modules.
+     * @brief Prepares the inputs
+     * @param repetitions Timed runs per case (at least 1)
      */
-    void run() {
-      int menuChoice;
+    explicit BenchmarkSuite(unsigned repetitions) : repetitions(max(1u, repetitions)) {}
 
-      // Display welcome banner
-      cout << "\n" << string(45, '*') << "\n";
-      cout << "   WELCOME TO PROGRAMMING ACTIVITY SYSTEM\n";
-      cout << string(45, '*') << "\n";
+    /**
+     * @brief Generates the inputs and runs every case
+     * @return One Result per case, in report order
+     */
+    vector<Result> run() {
+      vector<Result> results;
+      generateInputs();
 
-      // Main application loop
-      while (true) {
-        UI::line();
-        cout << ">>> ===== PROGRAMMING ACTIVITY MENU ===== <<<\n";
-        UI::line();
+      // Conversions: SIMD batch path, exact centavo path, and per-transaction convert()
+      CurrencyCalculator calculator;
+      RateSnapshotPublisher::ReadGuard snapshot = calculator.currentRates();
+      const size_t currencyCount = snapshot->table.size();
+      {
+        vector<double> fee(AMOUNT_COUNT), net(AMOUNT_COUNT), values(AMOUNT_COUNT * currencyCount);
+        vector<double*> converted(currencyCount);
+        for (size_t c = 0; c < currencyCount; c++) converted[c] = &values[AMOUNT_COUNT * c];
+        CurrencyCalculator::ConversionColumns columns = {fee.data(), net.data(), converted.data()};
+        results.push_back(measure("convert_batch", "conversions", AMOUNT_COUNT, [&]() {
+          calculator.convertBatch(amounts, columns, *snapshot);
+          keep(values[AMOUNT_COUNT - 1]);
+        }));
+      }
+      {
+        vector<int64_t> fee(AMOUNT_COUNT), net(AMOUNT_COUNT), values(AMOUNT_COUNT * currencyCount);
+        vector<int64_t*> converted(currencyCount);
+        for (size_t c = 0; c < currencyCount; c++) converted[c] = &values[AMOUNT_COUNT * c];
+        CurrencyCalculator::FixedConversionColumns columns = {fee.data(), net.data(), converted.data()};
+        results.push_back(measure("convert_fixed", "conversions", AMOUNT_COUNT, [&]() {
+          calculator.convertBatchFixed(centavos, columns, *snapshot, RoundingMode::HalfUp);
+          keep(static_cast<double>(values[AMOUNT_COUNT - 1]));
+        }));
+      }
+      results.push_back(measure("convert_single", "conversions", SINGLE_COUNT, [&]() {
+        double total = 0;
+        for (size_t i = 0; i < SINGLE_COUNT; i++) total += calculator.convert(amounts[i], *snapshot).netPHP;
+        keep(total);
+      }));
+
+      // Grades: averaging kernel alone, then parse + evaluate + format of roster text
+      results.push_back(measure("grade_kernel", "students", grades.size(), [&]() {
+        StudentGradeEvaluator::evaluateColumns(grades);
+        keep(grades.average[grades.size() - 1]);
+      }));
+      results.push_back(measure("grade_roster", "students", grades.size(), [&]() {
+        StudentGradeEvaluator::RosterChunk chunk;
+        StudentGradeEvaluator::evaluateChunk(rosterText, true, chunk);
+        keep(static_cast<double>(chunk.output.size()));
+      }));
+
+      // Triangles: rows rendered into memory, short (menu) and long (sliced) rows
+      for (int height : {TriangleActivity::MAX_HEIGHT, TRIANGLE_HEIGHT}) {
+        TriangleActivity::RowCache rows(height);
+        size_t repeats = TRIANGLE_ROWS / static_cast<size_t>(height);
+        string sink;
+        results.push_back(measure("triangle_rows_h" + to_string(height), "rows", repeats * static_cast<size_t>(height) * 2, [&]() {
+          sink.clear();
+          OutputWriter out(sink);
+          for (size_t i = 0; i < repeats; i++) {
+            TriangleActivity::displayRightTriangle(out, rows, height);
+            TriangleActivity::displayInvertedTriangle(out, rows, height);
+          }
+          out.flush();
+          keep(static_cast<double>(sink.size()));
+        }));
+      }
 
-        // Display dynamic menu from menuItems vector
-        for (size_t i = 0; i < menuItems.size(); ++i) {
-          cout << "[" << i + 1 << "] " << menuItems[i] << "\n";
+      // Validators: from_chars field parsing and the bulk SIMD range check
+      results.push_back(measure("validator_parse", "values", gradeTokens.size(), [&]() {
+        double total = 0, value;
+        for (string_view token : gradeTokens) {
+          if (InputValidator::parseDouble<StudentGradeEvaluator::MIN_GRADE, StudentGradeEvaluator::MAX_GRADE>(token, value)
+              == InputValidator::ParseResult::Valid) total += value;
         }
-        UI::line();
+        keep(total);
+      }));
+      {
+        vector<uint64_t> bits((AMOUNT_COUNT + 63) / 64);
+        results.push_back(measure("validator_bulk", "values", AMOUNT_COUNT, [&]() {
+          keep(static_cast<double>(InputValidator::validateColumn<CurrencyCalculator::MIN_AMOUNT, CurrencyCalculator::MAX_AMMOUNT>(amounts, bits.data())));
+        }));
+      }
 
-        // Get user's menu selection
-        menuChoice = InputValidator::getValidatedChoice(
-          "Enter choice (1-" + to_string(menuItems.size()) + "): ",
-          1,
-          static_cast <int> (menuItems.size())
-        );
+      // Startup: a fresh Program's first command to every module, then the whole process
+      results.push_back(measure("program_start", "starts", 1, [&]() {
+        Program program;
+        string output;
+        OutputWriter out(output);
+        ostringstream errors;
+        program.runScript(STARTUP_SCRIPT, out, errors);
+        out.flush();
+        keep(static_cast<double>(output.size()));
+      }));
+#if defined(__linux__)
+      results.push_back(measure("process_start", "starts", 1, [&]() { keep(spawnSelf()); }));
+#endif
+      return results;
+    }
 
-        // Route to selected activity
-        switch (menuChoice) {
-        case 1:
-          studentInfo.runStudentInfo();
-          break;
-        case 2:
-          gradeEvaluator.runStudentGradeEvaluator();
-          break;
-        case 3:
-          triangleActivity.runTriangleActivity();
-          break;
-        case 4:
-          currencyCalculator.runCurrencyCalculator();
-          break;
-        case 5:
-          UI::goodbyeMessage("Exiting program... Goodbye!\n");
-          return; // Exit application
-        default:
-          cout << "[ERROR] Choice must be 1-5. Try again.\n";
+    // @brief Writes one aligned line per case.
+    static void writeText(ostream& out, const vector<Result>& results) {
+      out << left << setw(22) << "benchmark" << right << setw(14) << "p50 ns" << setw(14) << "p90 ns"
+          << setw(14) << "p99 ns" << setw(18) << "items/s (p50)" << "  unit\n";
+      for (const Result& result : results) {
+        out << left << setw(22) << result.name << right << fixed << setprecision(0)
+            << setw(14) << result.percentile(50) << setw(14) << result.percentile(90) << setw(14) << result.percentile(99)
+            << setw(18) << result.itemsPerSecond() << "  " << result.unit << "\n";
+      }
+    }
+
+    // @brief Writes the results as one JSON document.
+    static void writeJson(ostream& out, const vector<Result>& results) {
+      out << "{\n  \"simd\": \"" << SIMD_NAME << "\",\n  \"benchmarks\": [";
+      for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        out << (i == 0 ? "\n" : ",\n") << fixed << setprecision(1)
+            << "    {\"name\": \"" << result.name << "\", \"unit\": \"" << result.unit << "\""
+            << ", \"items_per_run\": " << result.itemsPerRun
+            << ", \"repetitions\": " << result.runNanos.size()
+            << ", \"min_ns\": " << result.runNanos.front()
+            << ", \"p50_ns\": " << result.percentile(50)
+            << ", \"p90_ns\": " << result.percentile(90)
+            << ", \"p99_ns\": " << result.percentile(99)
+            << ", \"max_ns\": " << result.runNanos.back()
+            << ", \"items_per_second\": " << result.itemsPerSecond() << "}";
+      }
+      out << "\n  ]\n}\n";
+    }
+
+  private:
+    static constexpr size_t AMOUNT_COUNT = 1 << 16;      // Amounts per conversion run
+    static constexpr size_t SINGLE_COUNT = 1 << 12;      // convert() calls per run (each allocates a result)
+    static constexpr size_t STUDENT_COUNT = 1 << 15;     // Students per grading run
+    static constexpr int TRIANGLE_HEIGHT = 2000;         // Rows long enough for the writev() slice path
+    static constexpr size_t TRIANGLE_ROWS = 40000;       // Rows per shape per triangle run
+
+    // One command per module, so every lazily built module is built once
+    static constexpr string_view STARTUP_SCRIPT = "info\ngrades 90 85 88 92\ntriangle right 5\ncurrency convert 1000\n";
+
+#if defined(__AVX2__)
+    static constexpr const char* SIMD_NAME = "avx2";
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static constexpr const char* SIMD_NAME = "neon";
+#else
+    static constexpr const char* SIMD_NAME = "scalar";
+#endif
+
+    unsigned repetitions;
+    vector<double> amounts;
+    vector<int64_t> centavos;
+    StudentGradeEvaluator::GradeColumns grades;
+    string rosterText;
+    string tokenText;
+    vector<string_view> gradeTokens;
+
+    static inline volatile double sink = 0;   // Keeps results observable so runs are not optimized away
+
+    static void keep(double value) { sink = sink + value; }
+
+#if defined(__linux__)
+    // Runs this binary cold with one --run command and output to /dev/null; returns its exit status
+    static double spawnSelf() {
+      char program[] = "/proc/self/exe";
+      char run[] = "--run";
+      char command[] = "info";
+      char* arguments[] = {program, run, command, nullptr};
+
+      posix_spawn_file_actions_t actions;
+      posix_spawn_file_actions_init(&actions);
+      posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+      pid_t child;
+      int status = -1;
+      if (posix_spawn(&child, program, &actions, nullptr, arguments, environ) == 0) waitpid(child, &status, 0);
+      posix_spawn_file_actions_destroy(&actions);
+      return static_cast<double>(status);
+    }
+#endif
+
+    void generateInputs() {
+      mt19937_64 random(20240601);
+      uniform_int_distribution<int64_t> centavoDistribution(100 * 100, 100000 * 100);
+      uniform_int_distribution<int> hundredths(0, 10000);
+
+      for (size_t i = 0; i < AMOUNT_COUNT; i++) {
+        centavos.push_back(centavoDistribution(random));
+        amounts.push_back(static_cast<double>(centavos.back()) / 100);
+      }
+
+      char number[32];
+      for (size_t row = 0; row < STUDENT_COUNT; row++) {
+        double values[StudentGradeEvaluator::NUMBER_OF_GRADES];
+        string id = "S" + to_string(row);
+        rosterText += id;
+        for (double& value : values) {
+          value = hundredths(random) / 100.0;
+          char* end = to_chars(number, number + sizeof(number), value).ptr;
+          rosterText += ',';
+          rosterText.append(number, end);
+          tokenText.append(number, end) += '\n';
         }
+        rosterText += '\n';
+        grades.append(id, values);
+      }
+
+      for (size_t start = 0; start < tokenText.size();) {
+        size_t end = tokenText.find('\n', start);
+        gradeTokens.push_back(string_view(tokenText).substr(start, end - start));
+        start = end + 1;
+      }
+    }
+
+    template < typename Body >
+    Result measure(string name, string unit, size_t items, Body&& body) {
+      Result result{move(name), move(unit), items, {}};
+      body();   // warm-up: caches, page faults, lazy allocations
+
+      for (unsigned i = 0; i < repetitions; i++) {
+        auto started = chrono::steady_clock::now();
+        body();
+        chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - started;
+        result.runNanos.push_back(elapsed.count());
       }
+      sort(result.runNanos.begin(), result.runNanos.end());
+      return result;
     }
 };
 
 // ================================================== MAIN FUNCTION =================================================
+/**
+ * @struct CommandLineOptions
+ * @brief Options recognised on the command line
+ */
+struct CommandLineOptions {
+  string mode;                                              // "--grades", "--convert", "--triangle", "--script", "--run", "--serve", "--load", or empty for the menu
+  string inputPath;                                         // Roster or transaction file for the batch modes
+  string triangleShape;                                     // right, inverted or both for --triangle
+  int triangleHeight = 0;                                   // Rows for --triangle
+  string outputPath = "-";                                  // Destination for --triangle
+  string script;                                            // Commands given with --run, one per line
+  string serverAddress;                                     // unix:<path> or tcp:<host>:<port> for --serve, or headless too for --load
+  string ratesPath;                                         // Optional CODE,SYMBOL,RATE file replacing the built-in rates
+  string policyPath;                                        // Optional grading policy replacing the standard four periods
+  string updatesPath;                                       // Correction feed applied to the --grades roster
+  bool watchRates = false;                                  // Republish ratesPath whenever it changes
+  bool menuSessions = false;                                // --serve the interactive menu instead of the line protocol
+  bool json = false;                                        // --bench results as JSON
+  unsigned repetitions = 30;                                // Timed runs per --bench case
+  bool statistics = false;                                  // --grades also reports cohort statistics
+  ResultFormat format = ResultFormat::Text;                 // --grades and --convert result encoding
+  string metricsFormat;                                     // prometheus or json: dump Metrics to stderr at exit
+  bool fixedPoint = false;                                  // --convert with exact centavo arithmetic
+  RoundingMode rounding = RoundingMode::HalfUp;             // Rounding used by fixedPoint
+  unsigned threadCount = thread::hardware_concurrency();    // Workers for --grades, --triangle and --serve
+  string workloadPath;                                      // Recorded --load commands; empty for a synthetic mix
+  LoadGenerator::Mix mix;                                   // Synthetic --load weights of currency, grades and triangle commands
+  vector<unsigned> concurrency;                             // --load workers per run; empty for 1, 2, 4... up to the hardware threads
+  double requestsPerSecond = 0;                             // --load open-loop rate, 0 for a closed loop
+  double durationSeconds = 2;                               // Length of each --load run
+};
+
+// @brief Parses a comma-separated list of worker counts, each 1-LoadGenerator::MAX_CONCURRENCY.
+bool parseConcurrency(string_view text, vector<unsigned>& levels) {
+  levels.clear();
+  const char* position = text.data();
+  const char* end = text.data() + text.size();
+  while (true) {
+    unsigned level = 0;
+    auto [next, status] = from_chars(position, end, level);
+    if (status != errc() || level < 1 || level > LoadGenerator::MAX_CONCURRENCY) return false;
+    levels.push_back(level);
+    if (next == end) return true;
+    if (*next != ',') return false;
+    position = next + 1;
+  }
+}
+
+// @brief Parses a --qps or --duration value: a finite number above 0 and at most max.
+bool parseLoadSetting(string_view text, double max, double& value) {
+  double parsed = 0;
+  auto [next, status] = from_chars(text.data(), text.data() + text.size(), parsed);
+  if (status != errc() || next != text.data() + text.size() || !isfinite(parsed) || parsed <= 0 || parsed > max) return false;
+  value = parsed;
+  return true;
+}
+
+// @brief Parses a --bench repetition count, 1-BenchmarkSuite::MAX_REPETITIONS.
+bool parseRepetitions(string_view text, unsigned& repetitions) {
+  unsigned count = 0;
+  auto [next, status] = from_chars(text.data(), text.data() + text.size(), count);
+  if (status != errc() || next != text.data() + text.size() || count < 1 || count > BenchmarkSuite::MAX_REPETITIONS) return false;
+  repetitions = count;
+  return true;
+}
+
+// @brief Parses a --threads worker count, 1-WorkStealingPool::MAX_WORKERS whatever the hardware.
+bool parseThreadCount(string_view text, unsigned& threadCount) {
+  unsigned count = 0;
+  auto [next, status] = from_chars(text.data(), text.data() + text.size(), count);
+  if (status != errc() || next != text.data() + text.size() || count < 1 || count > WorkStealingPool::MAX_WORKERS) return false;
+  threadCount = count;
+  return true;
+}
+
+// @brief Parses a --triangle height; false if not a whole number, -1 if out of range (runTriangleRender rejects it).
+bool parseTriangleHeight(string_view text, int& height) {
+  long long rows = 0;
+  auto [next, status] = from_chars(text.data(), text.data() + text.size(), rows);
+  if (next == text.data() || next != text.data() + text.size()) return false;
+  if (status == errc::result_out_of_range || rows < 0 || rows > TriangleActivity::MAX_RENDER_HEIGHT) rows = -1;
+  height = static_cast<int>(rows);
+  return true;
+}
+
+/**
+ * @brief Parses argv into CommandLineOptions
+ * @return false (after printing usage) if an option is unknown or incomplete
+ */
+bool parseCommandLine(int argc, char* argv[], CommandLineOptions& options) {
+  for (int i = 1; i < argc; i++) {
+    string argument = argv[i];
+    bool hasValue = i + 1 < argc;
+
+    if ((argument == "--grades" || argument == "--convert") && hasValue && options.mode.empty()) {
+      options.mode = argument;
+      options.inputPath = argv[++i];
+    } else if (argument == "--script" && hasValue && options.mode.empty()) {
+      options.mode = argument;
+      options.inputPath = argv[++i];
+    } else if (argument == "--bench" && options.mode.empty()) {
+      options.mode = argument;
+    } else if (argument == "--json") {
+      options.json = true;
+    } else if (argument == "--repetitions" && hasValue && parseRepetitions(argv[i + 1], options.repetitions)) {
+      i++;
+    } else if ((argument == "--serve" || argument == "--load") && hasValue && options.mode.empty()) {
+      options.mode = argument;
+      options.serverAddress = argv[++i];
+    } else if (argument == "--workload" && hasValue) {
+      options.workloadPath = argv[++i];
+    } else if (argument == "--mix" && hasValue && LoadGenerator::parseMix(argv[i + 1], options.mix)) {
+      i++;
+    } else if (argument == "--concurrency" && hasValue && parseConcurrency(argv[i + 1], options.concurrency)) {
+      i++;
+    } else if (argument == "--qps" && hasValue && parseLoadSetting(argv[i + 1], LoadGenerator::MAX_REQUESTS_PER_SECOND, options.requestsPerSecond)) {
+      i++;
+    } else if (argument == "--duration" && hasValue && parseLoadSetting(argv[i + 1], LoadGenerator::MAX_DURATION_SECONDS, options.durationSeconds)) {
+      i++;
+    } else if (argument == "--run" && hasValue && (options.mode.empty() || options.mode == argument)) {
+      options.mode = argument;
+      options.script.append(argv[++i]) += '\n';
+    } else if (argument == "--triangle" && i + 2 < argc && options.mode.empty()) {
+      options.mode = argument;
+      options.triangleShape = argv[++i];
+      if (!parseTriangleHeight(argv[++i], options.triangleHeight)) {
+        cerr << "[ERROR] Triangle height is not a number: " << argv[i] << "\n";
+        return false;
+      }
+    } else if (argument == "--out" && hasValue) {
+      options.outputPath = argv[++i];
+    } else if (argument == "--threads" && hasValue) {
+      if (!parseThreadCount(argv[++i], options.threadCount)) {
+        cerr << "[ERROR] --threads must be 1-" << WorkStealingPool::MAX_WORKERS << "\n";
+        return false;
+      }
+    } else if (argument == "--rates" && hasValue) {
+      options.ratesPath = argv[++i];
+    } else if (argument == "--policy" && hasValue) {
+      options.policyPath = argv[++i];
+    } else if (argument == "--updates" && hasValue) {
+      options.updatesPath = argv[++i];
+    } else if (argument == "--watch-rates") {
+      options.watchRates = true;
+    } else if (argument == "--sessions") {
+      options.menuSessions = true;
+    } else if (argument == "--metrics" && hasValue && (string(argv[i + 1]) == "prometheus" || string(argv[i + 1]) == "json")) {
+      options.metricsFormat = argv[++i];
+    } else if (argument == "--format" && hasValue && (string(argv[i + 1]) == "text" || string(argv[i + 1]) == "columnar")) {
+      options.format = string(argv[++i]) == "text" ? ResultFormat::Text : ResultFormat::Columnar;
+    } else if (argument == "--stats") {
+      options.statistics = true;
+    } else if (argument == "--fixed") {
+      options.fixedPoint = true;
+    } else if (argument == "--rounding" && hasValue && FixedPoint::parseRoundingMode(argv[i + 1], options.rounding)) {
+      i++;
+    } else {
+      cerr << "Usage: " << argv[0] << " [--rates <rates.csv> [--watch-rates]] [--policy <policy.csv>]"
+           << " [--grades <roster.csv|-> [--threads N | --updates <updates.csv|->] [--stats] [--format text|columnar]"
+           << " | --convert <amounts.txt|-> [--fixed [--rounding half-up|half-even|down]] [--format text|columnar]"
+           << " | --triangle <right|inverted|both> <height> [--out <file>] [--threads N]"
+           << " | --script <commands.txt|-> | --run <command>..."
+           << " | --serve <unix:path|tcp:host:port> [--threads N | --sessions]"
+           << " | --bench [--json] [--repetitions N]"
+           << " | --load <headless|unix:path|tcp:host:port> [--workload <commands.txt|-> | --mix C,G,T]"
+           << " [--concurrency N,...] [--qps N] [--duration S] [--json]]"
+           << " [--metrics prometheus|json]\n";
+      return false;
+    }
+  }
+
+  if (options.watchRates && options.ratesPath.empty()) {
+    cerr << "[ERROR] --watch-rates needs --rates <rates.csv>\n";
+    return false;
+  }
+  if (!options.updatesPath.empty() && options.mode != "--grades") {
+    cerr << "[ERROR] --updates needs --grades <roster.csv>\n";
+    return false;
+  }
+  if (!options.updatesPath.empty() && options.inputPath == "-" && options.updatesPath == "-") {
+    cerr << "[ERROR] --grades and --updates cannot both read standard input\n";
+    return false;
+  }
+  if (!options.updatesPath.empty() && options.format != ResultFormat::Text) {
+    cerr << "[ERROR] --updates writes text results only\n";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Gives access to a whole input file or to all of standard input
+ * @param path File to map, or "-" to read standard input into buffered
+ * @param mapped Holds the mapping for files
+ * @param buffered Holds standard input
+ * @param text Receives the contents
+ * @return false (after printing an error) if the file cannot be opened
+ */
+bool openInput(const string& path, MappedFile& mapped, string& buffered, string_view& text) {
+  if (path == "-") {
+    buffered.assign(istreambuf_iterator<char>(cin), istreambuf_iterator<char>());
+    text = buffered;
+    return true;
+  }
+  if (!mapped.open(path)) {
+    cerr << "[ERROR] Cannot open file: " << path << "\n";
+    return false;
+  }
+  text = mapped.text();
+  return true;
+}
+
+/**
+ * @brief Loads the currency table named by --rates, or the built-in one
+ * @param ratesPath Rate file path; empty keeps the built-in rates
+ * @param table Receives the rates
+ * @return false (after printing the errors) if the file is missing or invalid
+ */
+bool loadCurrencyTable(const string& ratesPath, CurrencyTable& table) {
+  table = CurrencyTable::defaults();
+  if (ratesPath.empty()) return true;
+
+  MappedFile mapped;
+  string buffered;
+  string_view text;
+  if (!openInput(ratesPath, mapped, buffered, text)) return false;
+
+  vector<ParseError> errors;
+  if (table.load(text, errors)) return true;
+
+  for (const ParseError& error : errors) {
+    cerr << "[ERROR] " << ratesPath << " line " << error.line << ", column " << error.column << ": " << error.message << "\n";
+  }
+  if (errors.empty()) cerr << "[ERROR] " << ratesPath << " holds no rates\n";
+  return false;
+}
+
+/**
+ * @brief Loads the grading policy named by --policy, or the standard one
+ * @param policyPath Policy file path; empty keeps the standard policy
+ * @param policy Receives the policy
+ * @return false (after printing the errors) if the file is missing or invalid
+ */
+bool loadGradingPolicy(const string& policyPath, StudentGradeEvaluator::GradingPolicy& policy) {
+  policy = StudentGradeEvaluator::GradingPolicy::standard();
+  if (policyPath.empty()) return true;
+
+  MappedFile mapped;
+  string buffered;
+  string_view text;
+  if (!openInput(policyPath, mapped, buffered, text)) return false;
+
+  vector<ParseError> errors;
+  if (policy.load(text, errors)) return true;
+
+  for (const ParseError& error : errors) {
+    cerr << "[ERROR] " << policyPath << " line " << error.line << ", column " << error.column << ": " << error.message << "\n";
+  }
+  return false;
+}
+
+/**
+ * @brief Runs the non-interactive grade batch mode
+ * @param rosterPath Roster file to read, or "-" for standard input
+ * @param threadCount Worker threads; 1 evaluates on the calling thread
+ * @param statistics Also write StudentGradeEvaluator::writeStatistics() to standard error
+ * @param format Text "ID,Average,Remarks" lines or the ColumnarFormat file
+ * @param policy Periods, weights, passing grade and bands to grade with
+ * @return int Exit status (0 on success, 1 if the roster cannot be opened)
+ *
+ * Roster files are memory-mapped and parsed in place. Standard input is
+ * streamed block by block when single-threaded. Results go to standard
+ * output; rejected lines and the final summary go to standard error so
+ * the result stream stays clean.
+ */
+int runGradeBatch(const string& rosterPath, unsigned threadCount, bool statistics, ResultFormat format,
+                  const StudentGradeEvaluator::GradingPolicy& policy) {
+  StudentGradeEvaluator gradeEvaluator(policy);
+  StudentGradeEvaluator::RosterSummary summary;
+  unique_ptr<WorkStealingPool> pool;
+  if (threadCount > 1) pool = make_unique<WorkStealingPool>(threadCount);
+
+  if (rosterPath == "-") {
+    if (pool) {
+      // Chunks are cut from the whole roster, so read it in one go
+      string text((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>());
+      summary = gradeEvaluator.evaluateRoster(text, cout, cerr, pool.get(), format);
+    } else {
+      summary = gradeEvaluator.evaluateRoster(cin, cout, cerr, format);
+    }
+  } else {
+    MappedFile roster;
+    if (!roster.open(rosterPath)) {
+      cerr << "[ERROR] Cannot open roster file: " << rosterPath << "\n";
+      return 1;
+    }
+    summary = gradeEvaluator.evaluateRoster(roster.text(), cout, cerr, pool.get(), format);
+  }
+
+  cerr << "Evaluated " << summary.evaluated << " students: "
+       << summary.passed << " passed, "
+       << (summary.evaluated - summary.passed) << " failed, "
+       << summary.rejected << " rejected\n";
+  if (statistics) gradeEvaluator.writeStatistics(cerr, summary);
+  return 0;
+}
+
+/**
+ * @brief Runs the incremental grade mode: grade a roster once, then apply a feed of corrections
+ * @param rosterPath Roster file to read, or "-" for standard input
+ * @param updatesPath Correction feed, one "ID,Period,Grade" line each, or "-" for standard input
+ * @param statistics Also write the cohort report, as of the last correction, to standard error
+ * @param policy Periods, weights, passing grade and bands to grade with
+ * @return int Exit status (0 on success, 1 if an input cannot be opened)
+ *
+ * Writes the result header, then the re-graded "ID,Average,Remarks" line
+ * of the student each correction names, in feed order. The feed is read
+ * line by line and output is flushed whenever no more of it is buffered,
+ * so a feed piped in live is answered as it arrives. Rejected corrections
+ * are reported on standard error and leave the roster unchanged.
+ */
+int runGradeUpdates(const string& rosterPath, const string& updatesPath, bool statistics,
+                    const StudentGradeEvaluator::GradingPolicy& policy) {
+  MappedFile mapped;
+  string buffered;
+  string_view text;
+  ifstream file;
+  if (updatesPath != "-") {
+    file.open(updatesPath, ios::binary);
+    if (!file) {
+      cerr << "[ERROR] Cannot open file: " << updatesPath << "\n";
+      return 1;
+    }
+  }
+  istream& feed = updatesPath == "-" ? cin : file;
+
+  if (!openInput(rosterPath, mapped, buffered, text)) return 1;
+
+  StudentGradeEvaluator gradeEvaluator(policy);
+  StudentGradeEvaluator::IncrementalRoster roster(gradeEvaluator.gradingPolicy());
+  vector<ParseError> errors;
+  roster.load(text, errors);
+  for (const ParseError& error : errors) {
+    cerr << "[ERROR] Line " << error.line << ", column " << error.column << ": " << error.message << "\n";
+  }
+  const StudentGradeEvaluator::RosterSummary& summary = roster.summary();
+  cerr << "Evaluated " << summary.evaluated << " students: "
+       << summary.passed << " passed, "
+       << (summary.evaluated - summary.passed) << " failed, "
+       << summary.rejected << " rejected\n";
+
+  const size_t OUTPUT_BLOCK_SIZE = 1 << 16;  // Bytes buffered before each write, unless the feed runs dry first
+  StudentGradeEvaluator::writeResultHeader(cout, ResultFormat::Text, policy);
+  string output;
+  string line;
+  size_t lineNumber = 0, applied = 0, rejected = 0;
+  while (getline(feed, line)) {
+    lineNumber++;
+    FieldReader reader(line);
+    reader.nextLine();
+    if (reader.isBlankLine() || (lineNumber == 1 && FieldReader::isHeaderLine(reader.line(), "ID"))) continue;
+
+    size_t row = roster.apply(reader);
+    if (row == StudentGradeEvaluator::IncrementalRoster::NOT_FOUND) {
+      cerr << "[ERROR] Update line " << lineNumber << ", column " << reader.error().column << ": " << reader.error().message << "\n";
+      rejected++;
+      continue;
+    }
+    roster.appendRow(output, row);
+    applied++;
+
+    if (feed.rdbuf()->in_avail() <= 0 || output.size() >= OUTPUT_BLOCK_SIZE) {
+      cout.write(output.data(), static_cast<streamsize>(output.size()));
+      cout.flush();
+      output.clear();
+    }
+  }
+  cout.write(output.data(), static_cast<streamsize>(output.size()));
+  cout.flush();
+
+  cerr << "Applied " << applied << " updates, " << rejected << " rejected: "
+       << summary.passed << " passed, "
+       << (summary.evaluated - summary.passed) << " failed\n";
+  if (statistics) gradeEvaluator.writeStatistics(cerr, summary);
+  return 0;
+}
+
+/**
+ * @brief Starts a conversion result stream
+ * @param output Receives the "Amount,Fee,Net,<code>..." line or the columnar schema
+ * @param table Currencies, one result column each
+ * @param format Text or columnar
+ * @param type Columnar type of every column (Float64, or Int64 for fixed-point)
+ * @param scale Decimal scale of Int64 columns
+ */
+void writeConversionHeader(string& output, const CurrencyTable& table, ResultFormat format,
+                           ColumnarFormat::ColumnType type, int32_t scale = 0) {
+  if (format == ResultFormat::Text) {
+    output = "Amount,Fee,Net";
+    for (const CurrencyRate& currency : table) output += string(",") + currency.code;
+    output += '\n';
+    return;
+  }
+
+  vector<ColumnarFormat::ColumnDescriptor> schema = {
+    ColumnarFormat::column("amount", type, scale),
+    ColumnarFormat::column("fee", type, scale),
+    ColumnarFormat::column("net", type, scale),
+  };
+  for (const CurrencyRate& currency : table) schema.push_back(ColumnarFormat::column(currency.code, type, scale));
+  ColumnarFormat::appendSchema(output, schema);
+}
+
+/**
+ * @brief Runs the non-interactive currency batch mode
+ * @param amountsPath Transaction file (one PHP amount per line), or "-" for standard input
+ * @param table Currencies to convert to
+ * @param format Text lines or the ColumnarFormat file (Float64 columns)
+ * @return int Exit status (0 on success, 1 if the file cannot be opened)
+ *
+ * Writes "Amount,Fee,Net,<code>..." lines with two decimals to standard
+ * output, one converted column per table currency. Rejected lines and
+ * the summary go to standard error.
+ */
+int runCurrencyBatch(const string& amountsPath, const CurrencyTable& table, ResultFormat format) {
+  const size_t BLOCK_SIZE = 8192;            // Amounts converted per convertBatch() call
+  const size_t OUTPUT_BLOCK_SIZE = 1 << 16;  // Bytes buffered before each write
+
+  MappedFile mapped;
+  string buffered;
+  string_view text;
+  if (!openInput(amountsPath, mapped, buffered, text)) return 1;
+
+  vector<double> amounts;
+  vector<ParseError> errors;
+  amounts.reserve(text.size() / 8);
+  CurrencyCalculator::parseAmounts(text, amounts, errors);
+  for (const ParseError& error : errors) {
+    cerr << "[ERROR] Line " << error.line << ", column " << error.column << ": " << error.message << "\n";
+  }
+
+  CurrencyCalculator currencyCalculator(table);
+  RateSnapshotPublisher::ReadGuard snapshot = currencyCalculator.currentRates();
+  const size_t currencyCount = snapshot->table.size();
+  vector<double> results(BLOCK_SIZE * (currencyCount + 2));
+  vector<double*> converted(currencyCount);
+  for (size_t c = 0; c < currencyCount; c++) converted[c] = &results[BLOCK_SIZE * (c + 2)];
+  CurrencyCalculator::ConversionColumns columns = {&results[0], &results[BLOCK_SIZE], converted.data()};
+
+  string output;
+  writeConversionHeader(output, snapshot->table, format, ColumnarFormat::ColumnType::Float64);
+  output.reserve(OUTPUT_BLOCK_SIZE + 32 * (currencyCount + 3));
+  auto appendMoney = [&output](double value, char separator) {
+    char number[32];
+    output.append(number, to_chars(number, number + sizeof(number), value, chars_format::fixed, 2).ptr);
+    output += separator;
+  };
+
+  for (size_t start = 0; start < amounts.size(); start += BLOCK_SIZE) {
+    size_t count = min(BLOCK_SIZE, amounts.size() - start);
+    currencyCalculator.convertBatch(span<const double>(amounts.data() + start, count), columns, *snapshot);
+
+    if (format == ResultFormat::Columnar) {
+      size_t batch = ColumnarFormat::beginBatch(output, count);
+      ColumnarFormat::appendBuffer(output, amounts.data() + start, count * sizeof(double));
+      ColumnarFormat::appendBuffer(output, columns.fee, count * sizeof(double));
+      ColumnarFormat::appendBuffer(output, columns.netPHP, count * sizeof(double));
+      for (size_t c = 0; c < currencyCount; c++) ColumnarFormat::appendBuffer(output, converted[c], count * sizeof(double));
+      ColumnarFormat::endBatch(output, batch);
+      cout.write(output.data(), static_cast<streamsize>(output.size()));
+      output.clear();
+      continue;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      appendMoney(amounts[start + i], ',');
+      appendMoney(columns.fee[i], ',');
+      appendMoney(columns.netPHP[i], ',');
+      for (size_t c = 0; c < currencyCount; c++) appendMoney(converted[c][i], c + 1 < currencyCount ? ',' : '\n');
+
+      if (output.size() >= OUTPUT_BLOCK_SIZE) {
+        cout.write(output.data(), output.size());
+        output.clear();
+      }
+    }
+  }
+  cout.write(output.data(), output.size());
+  cout.flush();
+
+  cerr << "Converted " << amounts.size() << " transactions, " << errors.size() << " rejected"
+       << " (rate version " << snapshot->version << ")\n";
+  return 0;
+}
+
+/**
+ * @brief Runs the currency batch mode with exact centavo arithmetic
+ * @param amountsPath Transaction file (one PHP amount per line), or "-" for standard input
+ * @param table Currencies to convert to
+ * @param mode Rounding applied to amounts, fees and conversions
+ * @param format Text lines or the ColumnarFormat file (Int64 centavo columns, scale 2)
+ * @return int Exit status (0 on success, 1 if the file cannot be opened)
+ *
+ * Same output layout as runCurrencyBatch(), but every value is an int64
+ * count of hundredths and is printed without going through a double.
+ * The column totals are exact and are reported with the summary.
+ */
+int runFixedCurrencyBatch(const string& amountsPath, const CurrencyTable& table, RoundingMode mode, ResultFormat format) {
+  const size_t BLOCK_SIZE = 8192;            // Amounts converted per convertBatchFixed() call
+  const size_t OUTPUT_BLOCK_SIZE = 1 << 16;  // Bytes buffered before each write
+  const int DECIMALS = CurrencyCalculator::MONEY_DECIMALS;
+
+  MappedFile mapped;
+  string buffered;
+  string_view text;
+  if (!openInput(amountsPath, mapped, buffered, text)) return 1;
+
+  vector<int64_t> amounts;
+  vector<ParseError> errors;
+  amounts.reserve(text.size() / 8);
+  CurrencyCalculator::parseAmountsFixed(text, amounts, errors, mode);
+  for (const ParseError& error : errors) {
+    cerr << "[ERROR] Line " << error.line << ", column " << error.column << ": " << error.message << "\n";
+  }
+
+  CurrencyCalculator currencyCalculator(table);
+  RateSnapshotPublisher::ReadGuard snapshot = currencyCalculator.currentRates();
+  const size_t currencyCount = snapshot->table.size();
+  vector<int64_t> results(BLOCK_SIZE * (currencyCount + 2));
+  vector<int64_t*> converted(currencyCount);
+  for (size_t c = 0; c < currencyCount; c++) converted[c] = &results[BLOCK_SIZE * (c + 2)];
+  CurrencyCalculator::FixedConversionColumns columns = {&results[0], &results[BLOCK_SIZE], converted.data()};
+
+  // Totals: amount, fee, net, then one per currency
+  vector<int64_t> totals(currencyCount + 3, 0);
+
+  string output;
+  writeConversionHeader(output, snapshot->table, format, ColumnarFormat::ColumnType::Int64, DECIMALS);
+  output.reserve(OUTPUT_BLOCK_SIZE + 32 * (currencyCount + 3));
+  auto appendMoney = [&output](int64_t value, char separator) {
+    char number[32];
+    output.append(number, FixedPoint::format(number, value, DECIMALS));
+    output += separator;
+  };
+
+  for (size_t start = 0; start < amounts.size(); start += BLOCK_SIZE) {
+    size_t count = min(BLOCK_SIZE, amounts.size() - start);
+    currencyCalculator.convertBatchFixed(span<const int64_t>(amounts.data() + start, count), columns, *snapshot, mode);
+
+    if (format == ResultFormat::Columnar) {
+      size_t batch = ColumnarFormat::beginBatch(output, count);
+      ColumnarFormat::appendBuffer(output, amounts.data() + start, count * sizeof(int64_t));
+      ColumnarFormat::appendBuffer(output, columns.fee, count * sizeof(int64_t));
+      ColumnarFormat::appendBuffer(output, columns.netPHP, count * sizeof(int64_t));
+      for (size_t c = 0; c < currencyCount; c++) ColumnarFormat::appendBuffer(output, converted[c], count * sizeof(int64_t));
+      ColumnarFormat::endBatch(output, batch);
+      cout.write(output.data(), static_cast<streamsize>(output.size()));
+      output.clear();
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      totals[0] += amounts[start + i];
+      totals[1] += columns.fee[i];
+      totals[2] += columns.netPHP[i];
+      for (size_t c = 0; c < currencyCount; c++) totals[c + 3] += converted[c][i];
+      if (format == ResultFormat::Columnar) continue;
+
+      appendMoney(amounts[start + i], ',');
+      appendMoney(columns.fee[i], ',');
+      appendMoney(columns.netPHP[i], ',');
+      for (size_t c = 0; c < currencyCount; c++) appendMoney(converted[c][i], c + 1 < currencyCount ? ',' : '\n');
+
+      if (output.size() >= OUTPUT_BLOCK_SIZE) {
+        cout.write(output.data(), output.size());
+        output.clear();
+      }
+    }
+  }
+  cout.write(output.data(), output.size());
+  cout.flush();
+
+  char number[32];
+  cerr << "Converted " << amounts.size() << " transactions, " << errors.size() << " rejected"
+       << " (rate version " << snapshot->version << ", fixed-point)\n";
+  cerr << "Totals: Amount " << string_view(number, FixedPoint::format(number, totals[0], DECIMALS) - number);
+  cerr << ", Fee " << string_view(number, FixedPoint::format(number, totals[1], DECIMALS) - number);
+  cerr << ", Net " << string_view(number, FixedPoint::format(number, totals[2], DECIMALS) - number);
+  for (size_t c = 0; c < currencyCount; c++) {
+    cerr << ", " << snapshot->table[c].code << " " << string_view(number, FixedPoint::format(number, totals[c + 3], DECIMALS) - number);
+  }
+  cerr << "\n";
+  return 0;
+}
+
+/**
+ * @brief Renders a triangle pattern without the menu
+ * @param shape "right", "inverted" or "both"
+ * @param height Rows per triangle (1..TriangleActivity::MAX_RENDER_HEIGHT)
+ * @param outputPath File to write, or "-" for standard output
+ * @param threadCount Workers; above 1, files are rendered in parallel with pwrite()
+ * @return int Exit status (0 on success, 1 on bad arguments or write errors)
+ *
+ * "both" writes the right triangle, a blank line, then the inverted one.
+ * Only regular files are rendered in parallel. Standard output, devices
+ * and FIFOs are always written sequentially, as is every target where
+ * positioned writes (pwrite) are unavailable.
+ */
+int runTriangleRender(const string& shape, int height, const string& outputPath, unsigned threadCount) {
+  if (shape != "right" && shape != "inverted" && shape != "both") {
+    cerr << "[ERROR] Triangle shape must be right, inverted or both\n";
+    return 1;
+  }
+  if (height < 1 || height > TriangleActivity::MAX_RENDER_HEIGHT) {
+    cerr << "[ERROR] Height must be 1-" << TriangleActivity::MAX_RENDER_HEIGHT << "\n";
+    return 1;
+  }
+
+  // One cache serves both shapes
+  TriangleActivity::RowCache rows(height);
+  auto renderSequential = [&](OutputWriter& out) {
+    if (shape != "inverted") TriangleActivity::displayRightTriangle(out, rows, height);
+    if (shape == "both") out.put('\n');
+    if (shape != "right") TriangleActivity::displayInvertedTriangle(out, rows, height);
+    out.flush();
+    return out.good();
+  };
+
+  bool ok;
+#if defined(__unix__) || defined(__APPLE__)
+  int fd = STDOUT_FILENO;
+  if (outputPath != "-") {
+    fd = ::open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      cerr << "[ERROR] Cannot create output file: " << outputPath << "\n";
+      return 1;
+    }
+  }
+
+  // ftruncate() and pwrite() need a regular file; /dev/null and FIFOs reject them
+  struct stat info;
+  bool positioned = fd != STDOUT_FILENO && ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+
+  if (positioned && threadCount > 1) {
+    WorkStealingPool pool(threadCount);
+    uint64_t offset = 0;
+    ok = true;
+    if (shape != "inverted") {
+      ok = TriangleActivity::renderToFile(fd, rows, height, false, offset, pool);
+      offset += TriangleActivity::rowOffset(height, height, false);
+    }
+    if (shape == "both") {
+      ok = ok && ::pwrite(fd, "\n", 1, static_cast<off_t>(offset)) == 1;
+      offset++;
+    }
+    if (shape != "right") ok = ok && TriangleActivity::renderToFile(fd, rows, height, true, offset, pool);
+  } else {
+    OutputWriter out(fd);
+    ok = renderSequential(out);
+  }
+
+  if (fd != STDOUT_FILENO) ok = (::close(fd) == 0) && ok;
+#else
+  // No positioned writes here: every target is written sequentially
+  (void) threadCount;
+  ofstream file;
+  if (outputPath != "-") {
+    file.open(outputPath, ios::binary | ios::trunc);
+    if (!file) {
+      cerr << "[ERROR] Cannot create output file: " << outputPath << "\n";
+      return 1;
+    }
+  }
+  {
+    OutputWriter out(outputPath == "-" ? static_cast<ostream&>(cout) : file);
+    ok = renderSequential(out);
+  }
+  if (file.is_open()) {
+    file.close();
+    ok = ok && !file.fail();
+  }
+#endif
+  if (!ok) cerr << "[ERROR] Failed writing triangle output\n";
+  return ok ? 0 : 1;
+}
+
+/**
+ * @brief Runs a command script against the program without any prompts
+ * @param program Program whose menu dispatch runs the commands
+ * @param scriptPath Script file, or "-" for standard input; empty runs inlineScript
+ * @param inlineScript Commands collected from --run
+ * @return int Exit status (0 on success, 1 if the script cannot be opened,
+ *         a command failed or the output could not be written)
+ *
+ * Results are block-buffered to standard output. Failed commands and the
+ * final summary go to standard error, like the batch modes.
+ */
+int runProgramScript(Program& program, const string& scriptPath, const string& inlineScript) {
+  MappedFile mapped;
+  string buffered;
+  string_view text = inlineScript;
+  if (!scriptPath.empty() && !openInput(scriptPath, mapped, buffered, text)) return 1;
+
+  OutputWriter out(STDOUT_FILENO);
+  size_t failures = program.runScript(text, out, cerr);
+  out.flush();
+
+  if (failures > 0) cerr << failures << " script commands failed\n";
+  return out.good() && failures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Runs the microbenchmark suite and prints its report
+ * @param json true for JSON on standard output, false for a text table
+ * @param repetitions Timed runs per case
+ * @return int Exit status (always 0)
+ */
+int runBenchmarks(bool json, unsigned repetitions) {
+  BenchmarkSuite suite(repetitions);
+  vector<BenchmarkSuite::Result> results = suite.run();
+  if (json) BenchmarkSuite::writeJson(cout, results);
+  else BenchmarkSuite::writeText(cout, results);
+  return 0;
+}
+
+/**
+ * @brief Runs the load test mode and writes one result line per concurrency
+ * @param options The --load target, workload, concurrency levels, rate, duration and --json
+ * @param table Rates of the in-process Program for the headless target
+ * @param policy Grading policy of the headless Program, and the period count of synthetic "grades" commands
+ * @return int Exit status (0 on success, 1 if the workload cannot be read or the target fails)
+ *
+ * A socket target must already be serving (see --serve). Give the load
+ * test the same --policy as the server so synthetic grade commands fit it.
+ * Each level starts with a fresh set of workers; the headless Program
+ * is kept across levels, and one untimed pass over the workload builds
+ * its modules and warms its caches first.
+ */
+int runLoadTest(const CommandLineOptions& options, CurrencyTable table, StudentGradeEvaluator::GradingPolicy policy) {
+  vector<string> workload;
+  if (options.workloadPath.empty()) {
+    workload = LoadGenerator::synthesize(options.mix, policy.components());
+  } else {
+    MappedFile mapped;
+    string buffered;
+    string_view text;
+    if (!openInput(options.workloadPath, mapped, buffered, text)) return 1;
+    workload = LoadGenerator::loadWorkload(text);
+    if (workload.empty()) {
+      cerr << "[ERROR] " << options.workloadPath << " holds no commands\n";
+      return 1;
+    }
+  }
+
+  vector<unsigned> levels = options.concurrency;
+  if (levels.empty()) {
+    const unsigned hardware = max(1u, thread::hardware_concurrency());
+    for (unsigned level = 1; level < hardware; level *= 2) levels.push_back(level);
+    levels.push_back(hardware);
+  }
+
+  unique_ptr<Program> program;
+  if (options.serverAddress == "headless") {
+    program = make_unique<Program>(move(table), move(policy));
+    string output;
+    OutputWriter out(output);
+    ostringstream errors;
+    for (const string& request : workload) program->runScript(request, out, errors);
+  }
+
+  LoadGenerator generator(options.serverAddress, move(workload), program.get());
+  vector<LoadGenerator::Result> results;
+  for (unsigned level : levels) {
+    LoadGenerator::Result result;
+    if (!generator.run(level, options.requestsPerSecond, options.durationSeconds, result)) return 1;
+    results.push_back(move(result));
+  }
+
+  if (options.json) LoadGenerator::writeJson(cout, options.serverAddress, options.requestsPerSecond, results);
+  else LoadGenerator::writeText(cout, results);
+  return 0;
+}
+
+#if defined(__linux__)
+RequestServer* activeServer = nullptr;   // Stopped by SIGINT and SIGTERM
+
+void stopActiveServer(int) {
+  if (activeServer != nullptr) activeServer->stop();
+}
+#endif
+
+/**
+ * @brief Serves script commands on a socket until SIGINT or SIGTERM
+ * @param program Resident program the requests run against
+ * @param address unix:<path> or tcp:<host>:<port>
+ * @param threadCount Workers that run the requests
+ * @param menuSessions true to serve the interactive menu, one session per connection
+ * @return int Exit status (0 after a clean shutdown, 1 if the socket cannot be bound)
+ */
+int runRequestServer(const Program& program, const string& address, unsigned threadCount, bool menuSessions) {
+#if defined(__linux__)
+  RequestServer server(program, threadCount, menuSessions);
+  if (!server.listen(address)) return 1;
+
+  activeServer = &server;
+  signal(SIGINT, stopActiveServer);
+  signal(SIGTERM, stopActiveServer);
+  cerr << "[INFO] Serving on " << address << "\n";
+  server.run();
+  activeServer = nullptr;
+  return 0;
+#else
+  (void) program;
+  (void) address;
+  (void) threadCount;
+  (void) menuSessions;
+  cerr << "[ERROR] --serve needs epoll (Linux)\n";
+  return 1;
+#endif
+}
+
+/**
+ * @brief Drops the iostream costs that only a terminal user benefits from
+ *
+ * Turns off the C stdio sync, so cin and cout buffer on their own, and
+ * unties cin from cout, so reads no longer flush pending prompts. Must
+ * run before the first read or write of either stream.
+ */
+void enableFastStart() {
+  ios::sync_with_stdio(false);
+  cin.tie(nullptr);
+}
+
+// @brief Returns true if standard input may be a person at a terminal.
+bool isInteractive() {
+#if defined(__unix__) || defined(__APPLE__)
+  return isatty(STDIN_FILENO) != 0;
+#else
+  return true;
+#endif
+}
+
+// @brief Runs the batch mode, server, script or menu chosen on the command line.
+int runSelectedMode(const CommandLineOptions& options, CurrencyTable currencyTable, StudentGradeEvaluator::GradingPolicy gradingPolicy) {
+  if (options.mode == "--grades" && !options.updatesPath.empty()) {
+    return runGradeUpdates(options.inputPath, options.updatesPath, options.statistics, gradingPolicy);
+  }
+  if (options.mode == "--grades") return runGradeBatch(options.inputPath, options.threadCount, options.statistics, options.format, gradingPolicy);
+  if (options.mode == "--convert" && options.fixedPoint) {
+    return runFixedCurrencyBatch(options.inputPath, currencyTable, options.rounding, options.format);
+  }
+  if (options.mode == "--convert") return runCurrencyBatch(options.inputPath, currencyTable, options.format);
+  if (options.mode == "--bench") return runBenchmarks(options.json, options.repetitions);
+  if (options.mode == "--load") return runLoadTest(options, move(currencyTable), move(gradingPolicy));
+  if (options.mode == "--triangle") return runTriangleRender(options.triangleShape, options.triangleHeight, options.outputPath, options.threadCount);
+
+  Program program(move(currencyTable), move(gradingPolicy));   // Create main program instance
+
+  // Hot-reload the rates, if asked, for as long as the menu, script or server runs
+  unique_ptr<RateFileWatcher> rateWatcher;
+  if (options.watchRates) rateWatcher = make_unique<RateFileWatcher>(options.ratesPath, program.rateSnapshots());
+
+  if (options.mode == "--serve") return runRequestServer(program, options.serverAddress, options.threadCount, options.menuSessions);
+  if (options.mode == "--script" || options.mode == "--run") {
+    return runProgramScript(program, options.mode == "--script" ? options.inputPath : "", options.script);
+  }
+
+  program.run();                          // Start the application
+  
+  return 0;                               // Return success status
+}
+
 /**
  * @brief Application entry point
  * 
  * Creates the main Program instance and starts the application.
+ * Runs that nobody types into (every mode below, or the menu with
+ * piped input) start without stdio sync; see enableFastStart().
+ * Batch modes run instead when requested on the command line:
+ *   --grades <roster.csv|-> [--threads N]   evaluate a roster (N defaults to the hardware thread count)
+ *     --stats                               ...and report cohort means, percentiles and a histogram
+ *     --updates <updates.csv|->             ...then re-grade only the students an "ID,Period,Grade" feed corrects
+ *   --convert <amounts.txt|->               convert a file of PHP amounts
+ *     --fixed [--rounding <mode>]           ...with exact int64 centavo arithmetic
+ *   --format columnar                       write --grades/--convert results as a ColumnarFormat file
+ *   --triangle <shape> <height> [--out f]   render a right/inverted/both triangle pattern
+ *                                           (files are written by N threads with pwrite)
+ *   --script <commands.txt|->               run menu commands headlessly (see Program::runScript)
+ *   --run <command>                         ...or take them from argv, one per --run
+ *   --serve <address> [--threads N]         keep running and answer commands on a socket (see RequestServer)
+ *     --sessions                            ...or give every connection its own interactive menu
+ *   --bench [--json] [--repetitions N]      time every module's hot path (see BenchmarkSuite)
+ *   --load <headless|address>               replay a workload at rising concurrency and report latency (see LoadGenerator)
+ *     [--workload <commands.txt|->]         ...recorded commands, or a synthetic --mix C,G,T (default 60,30,10)
+ *     [--concurrency N,...] [--qps N]       ...workers per run (default 1, 2, 4... hardware threads), open-loop rate
+ *     [--duration S] [--json]               ...seconds per run (default 2), JSON report
+ *   --rates <rates.csv>                     replace the built-in exchange rates
+ *   --policy <policy.csv>                   grade with weighted periods and letter bands (see GradingPolicy)
+ *   --watch-rates                           reload the --rates file whenever it changes
+ *   --metrics <prometheus|json>             write the collected Metrics to stderr on exit
  * 
  * @return int Exit status (0 for successful execution)
  */
-int main() {
-  Program program;          // Create main program instance
-  program.run();            // Start the application
-  
-  return 0;                 // Return success status
-}
\ No newline at end of file
+int main(int argc, char* argv[]) {
+  CommandLineOptions options;
+  if (!parseCommandLine(argc, argv, options)) return 1;
+
+  // Only the menu on a terminal needs every prompt flushed before each read
+  if (!options.mode.empty() || !isInteractive()) enableFastStart();
+
+  CurrencyTable currencyTable;
+  if (!loadCurrencyTable(options.ratesPath, currencyTable)) return 1;
+  StudentGradeEvaluator::GradingPolicy gradingPolicy;
+  if (!loadGradingPolicy(options.policyPath, gradingPolicy)) return 1;
+
+  int status = runSelectedMode(options, move(currencyTable), move(gradingPolicy));
+
+  if (options.metricsFormat == "json") Metrics::writeJson(cerr, Metrics::snapshot());
+  else if (!options.metricsFormat.empty()) Metrics::writePrometheus(cerr, Metrics::snapshot());
+  return status;
+}